@@ -0,0 +1,87 @@
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "tsc_core_matrix.h"
+
+namespace {
+
+    void print_usage(const char* program) {
+        std::cerr << "Usage: " << program << " [--cpus=0,1,...] [--rounds=N] [--format=table|csv|json]"
+                  << " [--barrier=rdtscp|lfence|mfence|cpuid|twocpuid|auto]\n";
+    }
+
+    std::vector<int> parse_cpus(const std::string& list) {
+        std::vector<int> cpus;
+        std::stringstream stream{list};
+        for (std::string item; std::getline(stream, item, ',');) {
+            cpus.push_back(std::stoi(item));
+        }
+        return cpus;
+    }
+
+    template<benchmarking::Barrier BarrierType>
+    benchmarking::CoreLatencyMatrix measure(const std::vector<int>& cpus, std::size_t rounds) {
+        return benchmarking::CoreLatencyMatrix::Measure<BarrierType>(cpus, rounds);
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<int> cpus = benchmarking::details::GetCpuList();
+    std::size_t rounds = benchmarking::CoreLatencyMatrix::kDefaultRounds;
+    std::string format = "table";
+    std::string barrier = "rdtscp";
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&arg]() { return arg.substr(arg.find('=') + 1); };
+        if (arg.rfind("--cpus=", 0) == 0) {
+            cpus = parse_cpus(value());
+        } else if (arg.rfind("--rounds=", 0) == 0) {
+            rounds = std::stoul(value());
+        } else if (arg.rfind("--format=", 0) == 0) {
+            format = value();
+        } else if (arg.rfind("--barrier=", 0) == 0) {
+            barrier = value();
+        } else {
+            print_usage(argv[0]);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    if (cpus.size() < 2) {
+        std::cerr << "[Warning] At least two CPU cores are needed for a latency matrix" << std::endl;
+    }
+
+    using benchmarking::Barrier;
+    benchmarking::CoreLatencyMatrix matrix;
+    if (barrier == "rdtscp") {
+        matrix = measure<Barrier::kRdtscp>(cpus, rounds);
+    } else if (barrier == "lfence") {
+        matrix = measure<Barrier::kLFence>(cpus, rounds);
+    } else if (barrier == "mfence") {
+        matrix = measure<Barrier::kMFence>(cpus, rounds);
+    } else if (barrier == "cpuid") {
+        matrix = measure<Barrier::kOneCpuId>(cpus, rounds);
+    } else if (barrier == "twocpuid") {
+        matrix = measure<Barrier::kTwoCpuId>(cpus, rounds);
+    } else if (barrier == "auto") {
+        matrix = measure<Barrier::kAuto>(cpus, rounds);
+    } else {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    auto calibration = benchmarking::TSCCalibration::Calibrate();
+    if (format == "csv") {
+        matrix.WriteCsv(std::cout, calibration);
+    } else if (format == "json") {
+        matrix.WriteJson(std::cout, calibration);
+    } else {
+        matrix.WriteTable(std::cout, calibration);
+    }
+    return 0;
+}
@@ -0,0 +1,335 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <linux/futex.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "tsc_cache.h"
+#include "tsc_registry.h"
+
+// Microarchitectural baseline of host: memory hierarchy latency, copy bandwidth, atomics,
+// synchronization and kernel entry cost. Run on every new CPU generation or kernel:
+//   ./tsc_microbench --cpu=2 --out=baseline
+//   ./tsc_microbench --cpu=2 --baseline=baseline.samples.csv
+
+namespace {
+
+    using benchmarking::SuiteBenchmark;
+
+    // Hops (or operations) timed between one pair of timestamps
+    constexpr std::size_t kBatch = 16;
+
+    /// Lines linked into single random cycle - every load depends on previous one and defeats prefetchers
+    class PointerChase {
+    public:
+        explicit PointerChase(std::size_t bytes)
+                : lines_{std::max<std::size_t>(bytes / sizeof(Line), 2)}, buffer_{new Line[lines_]} {
+            std::vector<std::size_t> order(lines_);
+            std::iota(order.begin(), order.end(), 0);
+            std::shuffle(order.begin() + 1, order.end(), std::mt19937_64{42});
+            for (std::size_t i = 0; i < lines_; ++i) {
+                buffer_[order[i]].next_ = &buffer_[order[(i + 1) % lines_]];
+            }
+            position_ = &buffer_[0];
+        }
+
+        FORCE_INLINE void Hop() noexcept { position_ = position_->next_; }
+
+        [[nodiscard]] const void* Position() const noexcept { return position_; }
+
+    private:
+        struct alignas(benchmarking::kCacheLineSize) Line {
+            Line* next_{nullptr};
+        };
+
+        std::size_t lines_;
+        std::unique_ptr<Line[]> buffer_;
+        Line* position_{nullptr};
+    };
+
+    /// Data or unified cache size of level (0 if level is not present)
+    std::size_t cache_bytes(int level) {
+        for (const benchmarking::CacheLevel& cache : benchmarking::details::ReadCacheLevels()) {
+            if (cache.level_ == level) {
+                return cache.size_bytes_;
+            }
+        }
+        return 0;
+    }
+
+    std::size_t last_level_bytes() {
+        const std::vector<benchmarking::CacheLevel> levels = benchmarking::details::ReadCacheLevels();
+        return levels.empty() ? std::size_t{32} << 20 : levels.back().size_bytes_;
+    }
+
+    SuiteBenchmark::Result run_chase(SuiteBenchmark& benchmark, const SuiteBenchmark::Settings& settings,
+                                     std::size_t bytes) {
+        PointerChase chase{bytes};
+        // One pass over working set before sampling so that it is resident in target level
+        SuiteBenchmark::Settings chase_settings = settings;
+        chase_settings.cache_warmup_cycles_number_ = std::max(settings.cache_warmup_cycles_number_,
+                                                              bytes / benchmarking::kCacheLineSize);
+        SuiteBenchmark::Result result = benchmark.RunBatched<kBatch>([&chase]() { chase.Hop(); }, chase_settings);
+        benchmarking::DoNotOptimize(chase.Position());
+        return result;
+    }
+
+    /// First CPU other than benchmark CPU (-1 on single-CPU hosts)
+    int partner_cpu(int cpu) {
+        for (int candidate : benchmarking::details::GetPlacementCpuList()) {
+            if (candidate != cpu) {
+                return candidate;
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * Thread pinned to another CPU that runs body until destroyed. Partner runs with SCHED_OTHER
+     * so it never competes with real-time benchmark thread. Without second CPU (or if partner
+     * cannot be pinned to it) body never runs and benchmark measures uncontended case.
+     */
+    class Partner {
+    public:
+        template<typename Body>
+        Partner(int benchmark_cpu, Body body) {
+            const int cpu = partner_cpu(benchmark_cpu);
+            if (cpu < 0) {
+                std::cerr << "[Warning] Single CPU - contended benchmark runs uncontended" << std::endl;
+                return;
+            }
+            thread_ = std::thread{[this, cpu, body]() mutable {
+                sched_param param{};
+                pthread_setschedparam(pthread_self(), SCHED_OTHER, &param);
+                // Unpinned partner would inherit benchmark CPU and time-slice with it
+                const bool pinned = benchmarking::details::PinThread(cpu, false);
+                started_.store(true, std::memory_order_release);
+                if (!pinned) {
+                    std::cerr << "[Warning] Partner could not be pinned to CPU " << cpu
+                              << " - contended benchmark runs uncontended" << std::endl;
+                    return;
+                }
+                while (!stop_.load(std::memory_order_relaxed)) {
+                    body();
+                }
+            }};
+            while (!started_.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+        }
+
+        Partner(const Partner&) = delete;
+        Partner& operator=(const Partner&) = delete;
+
+        ~Partner() {
+            stop_.store(true, std::memory_order_relaxed);
+            if (thread_.joinable()) {
+                thread_.join();
+            }
+        }
+
+    private:
+        std::atomic<bool> stop_{false};
+        std::atomic<bool> started_{false};
+        std::thread thread_{};
+    };
+
+    long futex(std::atomic<std::uint32_t>& word, int operation, std::uint32_t value) {
+        return syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), operation, value, nullptr, nullptr, 0);
+    }
+
+    template<std::size_t Bytes>
+    SuiteBenchmark::Result run_memcpy(SuiteBenchmark& benchmark, const SuiteBenchmark::Settings& settings) {
+        std::vector<char> source(Bytes, 1), destination(Bytes, 0);
+        SuiteBenchmark::Settings copy_settings = settings;
+        // Large copies take milliseconds - fewer samples keep suite time bounded
+        copy_settings.cycles_number_ = std::min<std::size_t>(settings.cycles_number_, (std::size_t{256} << 20) / Bytes);
+        return benchmark.Run([&source, &destination]() {
+            std::memcpy(destination.data(), source.data(), Bytes);
+            benchmarking::ClobberMemory();
+        }, copy_settings);
+    }
+
+    template<std::size_t Bytes>
+    SuiteBenchmark::Result run_memset(SuiteBenchmark& benchmark, const SuiteBenchmark::Settings& settings) {
+        std::vector<char> destination(Bytes, 0);
+        SuiteBenchmark::Settings set_settings = settings;
+        set_settings.cycles_number_ = std::min<std::size_t>(settings.cycles_number_, (std::size_t{256} << 20) / Bytes);
+        int value = 0;
+        return benchmark.Run([&destination, &value]() {
+            std::memset(destination.data(), ++value, Bytes);
+            benchmarking::ClobberMemory();
+        }, set_settings);
+    }
+
+    struct alignas(benchmarking::kCacheLineSize) PaddedCounter {
+        std::atomic<std::uint64_t> value_{0};
+    };
+
+    struct alignas(benchmarking::kCacheLineSize) SharedLine {
+        std::atomic<std::uint64_t> first_{0};
+        std::atomic<std::uint64_t> second_{0};
+    };
+
+} // namespace
+
+// Memory hierarchy: per-hop latency of dependent loads over working set half the size of level
+// (DRAM - 4x LLC, 64 MiB to 512 MiB)
+
+TSC_BENCHMARK(latency_l1) {
+    return run_chase(benchmark, settings, std::max<std::size_t>(cache_bytes(1), 8192) / 2);
+}
+
+TSC_BENCHMARK(latency_l2) {
+    return run_chase(benchmark, settings, std::max<std::size_t>(cache_bytes(2), std::size_t{256} << 10) / 2);
+}
+
+TSC_BENCHMARK(latency_l3) {
+    return run_chase(benchmark, settings, last_level_bytes() / 2);
+}
+
+TSC_BENCHMARK(latency_dram) {
+    return run_chase(benchmark, settings, std::clamp(last_level_bytes() * 4, std::size_t{64} << 20, std::size_t{512} << 20));
+}
+
+// Copy and fill bandwidth by size (bytes / median)
+
+TSC_BENCHMARK(memcpy_4k) { return run_memcpy<std::size_t{4} << 10>(benchmark, settings); }
+TSC_BENCHMARK(memcpy_64k) { return run_memcpy<std::size_t{64} << 10>(benchmark, settings); }
+TSC_BENCHMARK(memcpy_1m) { return run_memcpy<std::size_t{1} << 20>(benchmark, settings); }
+TSC_BENCHMARK(memcpy_16m) { return run_memcpy<std::size_t{16} << 20>(benchmark, settings); }
+
+TSC_BENCHMARK(memset_4k) { return run_memset<std::size_t{4} << 10>(benchmark, settings); }
+TSC_BENCHMARK(memset_64k) { return run_memset<std::size_t{64} << 10>(benchmark, settings); }
+TSC_BENCHMARK(memset_1m) { return run_memset<std::size_t{1} << 20>(benchmark, settings); }
+TSC_BENCHMARK(memset_16m) { return run_memset<std::size_t{16} << 20>(benchmark, settings); }
+
+// Atomics: per-operation cost, contended variants race partner thread on another CPU for the same line
+
+TSC_BENCHMARK(atomic_fetch_add) {
+    PaddedCounter counter{};
+    return benchmark.RunBatched<kBatch>([&counter]() { counter.value_.fetch_add(1); }, settings);
+}
+
+TSC_BENCHMARK(atomic_cas) {
+    PaddedCounter counter{};
+    return benchmark.RunBatched<kBatch>([&counter]() {
+        std::uint64_t expected = counter.value_.load(std::memory_order_relaxed);
+        counter.value_.compare_exchange_strong(expected, expected + 1);
+    }, settings);
+}
+
+TSC_BENCHMARK(atomic_fetch_add_contended) {
+    PaddedCounter counter{};
+    Partner partner{settings.cpu_, [&counter]() { counter.value_.fetch_add(1); }};
+    return benchmark.RunBatched<kBatch>([&counter]() { counter.value_.fetch_add(1); }, settings);
+}
+
+TSC_BENCHMARK(atomic_cas_contended) {
+    PaddedCounter counter{};
+    auto increment = [&counter]() {
+        std::uint64_t expected = counter.value_.load(std::memory_order_relaxed);
+        while (!counter.value_.compare_exchange_weak(expected, expected + 1)) {
+        }
+    };
+    Partner partner{settings.cpu_, increment};
+    return benchmark.RunBatched<kBatch>(increment, settings);
+}
+
+// False sharing: same writes as partner to adjacent word of one line versus separate lines
+
+TSC_BENCHMARK(false_sharing_shared_line) {
+    SharedLine line{};
+    Partner partner{settings.cpu_, [&line]() { line.second_.fetch_add(1, std::memory_order_relaxed); }};
+    return benchmark.RunBatched<kBatch>([&line]() { line.first_.fetch_add(1, std::memory_order_relaxed); }, settings);
+}
+
+TSC_BENCHMARK(false_sharing_padded) {
+    PaddedCounter first{}, second{};
+    Partner partner{settings.cpu_, [&second]() { second.value_.fetch_add(1, std::memory_order_relaxed); }};
+    return benchmark.RunBatched<kBatch>([&first]() { first.value_.fetch_add(1, std::memory_order_relaxed); }, settings);
+}
+
+// Synchronization
+
+TSC_BENCHMARK(mutex_lock_unlock) {
+    std::mutex mutex;
+    return benchmark.RunBatched<kBatch>([&mutex]() {
+        mutex.lock();
+        mutex.unlock();
+    }, settings);
+}
+
+TSC_BENCHMARK(futex_wake_no_waiters) {
+    std::atomic<std::uint32_t> word{0};
+    return benchmark.Run([&word]() { futex(word, FUTEX_WAKE_PRIVATE, 1); }, settings);
+}
+
+TSC_BENCHMARK(futex_round_trip) {
+    // Ping-pong through futex: benchmark thread posts 1 and sleeps until partner answers with 0.
+    // Both sides block, so it also works (as a context switch round trip) on a single CPU.
+    auto word = std::make_unique<std::atomic<std::uint32_t>>(0);
+    std::atomic<bool> stop{false};
+    const int cpu = partner_cpu(settings.cpu_);
+    std::thread partner{[&word, &stop, cpu, benchmark_cpu = settings.cpu_]() {
+        sched_param param{};
+        pthread_setschedparam(pthread_self(), SCHED_OTHER, &param);
+        // Partner must answer even if it cannot leave benchmark CPU, otherwise benchmark blocks forever
+        if (cpu < 0 || !benchmarking::details::PinThread(cpu, false)) {
+            if (cpu >= 0) {
+                std::cerr << "[Warning] Futex partner could not be pinned to CPU " << cpu
+                          << " - measuring same-CPU context switch round trip" << std::endl;
+            }
+            benchmarking::details::PinThread(benchmark_cpu, false);
+        }
+        while (!stop.load(std::memory_order_acquire)) {
+            if (word->load(std::memory_order_acquire) == 1) {
+                word->store(0, std::memory_order_release);
+                futex(*word, FUTEX_WAKE_PRIVATE, 1);
+            } else {
+                futex(*word, FUTEX_WAIT_PRIVATE, 0);
+            }
+        }
+    }};
+    SuiteBenchmark::Result result = benchmark.Run([&word]() {
+        word->store(1, std::memory_order_release);
+        futex(*word, FUTEX_WAKE_PRIVATE, 1);
+        while (word->load(std::memory_order_acquire) == 1) {
+            futex(*word, FUTEX_WAIT_PRIVATE, 1);
+        }
+    }, settings);
+    stop.store(true, std::memory_order_release);
+    word->store(2, std::memory_order_release);
+    futex(*word, FUTEX_WAKE_PRIVATE, 1);
+    partner.join();
+    return result;
+}
+
+// Kernel entry: real system call versus vDSO call that stays in user space
+
+TSC_BENCHMARK(syscall_getppid) {
+    return benchmark.Run([]() { return syscall(SYS_getppid); }, settings);
+}
+
+TSC_BENCHMARK(vdso_clock_gettime) {
+    return benchmark.RunBatched<kBatch>([]() {
+        timespec time{};
+        clock_gettime(CLOCK_MONOTONIC, &time);
+        benchmarking::DoNotOptimize(time);
+    }, settings);
+}
+
+TSC_BENCHMARK_MAIN()
@@ -22,6 +22,7 @@ int main() {
     settings.cycles_number_ = 1000;
     settings.cpu_ = 0;
     settings.cache_warmup_cycles_number_ = 100;
+    settings.overhead_correction_ = benchmarking::OverheadCorrection::kSubtractMin;
 
     // Define code to benchmark
     auto code_for_benchmarking = [&test_vector]() {
@@ -40,9 +41,9 @@ int main() {
     auto result = benchmark.Run(code_for_benchmarking, settings);
     
     std::cout << "\nResults:\n";
-    std::cout << "- Execution time: " << result.time_ << " ns\n";
-    std::cout << "- TSC overhead: " << result.overhead_ << " ns\n";
-    std::cout << "- Net time: " << (result.time_ - result.overhead_) << " ns\n";
+    std::cout << "- Execution time: " << result.time_ << " cycles (" << result.time_ns_.count() << " ns)\n";
+    std::cout << "- TSC overhead: " << result.overhead_ << " cycles (" << result.overhead_ns_.count() << " ns)\n";
+    std::cout << "- Net time: " << result.corrected_time_ << " cycles (" << result.corrected_time_ns_.count() << " ns)\n";
     
     return 0;
 }
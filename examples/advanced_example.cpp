@@ -0,0 +1,1035 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <chrono>
+#include <iomanip>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <thread>
+
+#include "../include/tsc_benchmark.h"
+#include "../include/tsc_complexity.h"
+#include "../include/tsc_coroutine.h"
+#include "../include/tsc_loaded.h"
+#include "../include/tsc_probe.h"
+#include "../include/tsc_sample_file.h"
+#include "../include/tsc_trace.h"
+
+void demonstrate_basic_usage() {
+    std::cout << "\n=== Basic Usage Example ===\n";
+    
+    using Benchmark = benchmarking::TSCBenchmarking<false, benchmarking::Barrier::kOneCpuId>;
+    
+    Benchmark benchmark{};
+    benchmark.Initialize();
+    
+    // Simple arithmetic operation
+    auto simple_operation = []() {
+        int result = 0;
+        for (int i = 0; i < 100; ++i) {
+            benchmarking::DoNotOptimize(result += i * 2);
+        }
+        return result;
+    };
+    
+    Benchmark::Settings settings{};
+    settings.cycles_number_ = 1000;
+    settings.cpu_ = 0;
+    settings.cache_warmup_cycles_number_ = 100;
+    settings.overhead_correction_ = benchmarking::OverheadCorrection::kSubtractMin;
+    
+    auto result = benchmark.Run(simple_operation, settings);
+    
+    std::cout << "Simple arithmetic (100 iterations):\n";
+    std::cout << "  Time: " << result.time_ << " cycles (" << result.time_ns_.count() << " ns)\n";
+    std::cout << "  Overhead: " << result.overhead_ << " cycles (" << result.overhead_ns_.count() << " ns)\n";
+    std::cout << "  Net time: " << result.corrected_time_ << " cycles (" << result.corrected_time_ns_.count() << " ns)\n";
+}
+
+void demonstrate_latency_distribution() {
+    std::cout << "\n=== Latency Distribution ===\n";
+    
+    using Benchmark = benchmarking::TSCBenchmarking<false, benchmarking::Barrier::kOneCpuId>;
+    
+    Benchmark::Settings settings{};
+    settings.cycles_number_ = 10000;
+    settings.cpu_ = 0;
+    settings.cache_warmup_cycles_number_ = 100;
+    settings.record_samples_ = true;
+    
+    // Sample buffer is preallocated before pages are locked
+    Benchmark benchmark{};
+    benchmark.Initialize(settings);
+    
+    auto operation = []() {
+        int x = 42;
+        benchmarking::DoNotOptimize(x);
+        return x * x + 1;
+    };
+    
+    auto result = benchmark.Run(operation, settings);
+    const auto& distribution = result.distribution_;
+    
+    std::cout << "Samples: " << distribution.samples_number_ << "\n";
+    std::cout << "  min:    " << distribution.min_ << " cycles\n";
+    std::cout << "  median: " << distribution.median_ << " cycles\n";
+    std::cout << "  p90:    " << distribution.p90_ << " cycles\n";
+    std::cout << "  p99:    " << distribution.p99_ << " cycles\n";
+    std::cout << "  p99.9:  " << distribution.p999_ << " cycles\n";
+    std::cout << "  max:    " << distribution.max_ << " cycles\n";
+    std::cout << "  mean:   " << distribution.mean_ << " cycles, stddev " << distribution.stddev_
+              << ", MAD " << distribution.mad_ << "\n";
+}
+
+void demonstrate_adaptive_sampling() {
+    std::cout << "\n=== Adaptive Sampling ===\n";
+    
+    using Benchmark = benchmarking::TSCBenchmarking<false, benchmarking::Barrier::kOneCpuId>;
+    
+    Benchmark::Settings settings{};
+    settings.cycles_number_ = 200000;
+    settings.cpu_ = 0;
+    settings.cache_warmup_cycles_number_ = 100;
+    settings.target_relative_ci_ = 0.02;
+    settings.max_time_budget_ = std::chrono::milliseconds{200};
+    settings.record_samples_ = true;    // lets Initialize() preallocate the buffer
+    
+    Benchmark benchmark{};
+    benchmark.Initialize(settings);
+    
+    auto operation = []() {
+        int x = 42;
+        benchmarking::DoNotOptimize(x);
+        return x * x + 1;
+    };
+    
+    auto result = benchmark.RunAdaptive(operation, settings);
+    
+    std::cout << "Samples used: " << result.samples_number_ << " of " << settings.cycles_number_
+              << (result.converged_ ? " (converged)\n" : " (budget exhausted)\n");
+    std::cout << "  median: " << result.median_ci_.estimate_ << " cycles ["
+              << result.median_ci_.lower_ << ", " << result.median_ci_.upper_ << "]\n";
+    std::cout << "  p99:    " << result.p99_ci_.estimate_ << " cycles ["
+              << result.p99_ci_.lower_ << ", " << result.p99_ci_.upper_ << "]\n";
+}
+
+void demonstrate_outlier_filtering() {
+    std::cout << "\n=== Outlier Filtering ===\n";
+    
+    using Benchmark = benchmarking::TSCBenchmarking<false, benchmarking::Barrier::kOneCpuId>;
+    
+    Benchmark::Settings settings{};
+    settings.cycles_number_ = 20000;
+    settings.record_samples_ = true;
+    settings.overhead_correction_ = benchmarking::OverheadCorrection::kSubtractMin;
+    settings.outliers_.enabled_ = true;
+    
+    // Buffer is sized for adaptive runs below
+    Benchmark::Settings preallocate = settings;
+    preallocate.cycles_number_ = 200000;
+    Benchmark benchmark{};
+    benchmark.Initialize(preallocate);
+    
+    // Every 500th call stalls for 10000 cycles, as if an interrupt landed inside the sample
+    std::uint64_t calls = 0;
+    auto stalled = [&calls]() {
+        if (++calls % 500 == 0) {
+            const benchmarking::TimePoint until = benchmarking::details::Rdtsc() + 10000;
+            while (benchmarking::details::Rdtsc() < until) {
+            }
+        }
+        std::uint64_t x = calls;
+        benchmarking::DoNotOptimize(x);
+    };
+    auto result = benchmark.Run(stalled, settings);
+    const benchmarking::OutlierReport& report = result.outliers_;
+    std::cout << "Kept " << report.kept_number_ << ", rejected " << report.rejected_number_ << " (interrupt gap "
+              << report.interrupt_gap_number_ << ", Tukey " << report.tukey_number_ << ", MAD " << report.mad_number_
+              << ")" << (report.bimodal_ ? ", bimodal - Tukey/MAD skipped" : "") << "\n";
+    std::cout << std::fixed << std::setprecision(1) << "Mean unfiltered " << report.unfiltered_.mean_
+              << " cycles, filtered " << report.filtered_.mean_ << " cycles (median " << report.filtered_.median_
+              << ")\n";
+    
+    // Two code paths taken alternately - bimodal, so Tukey/MAD keep the slow mode
+    auto two_paths = [&calls]() {
+        std::uint64_t x = ++calls;
+        if (calls % 2 == 0) {
+            for (int i = 0; i < 50; ++i) {
+                benchmarking::DoNotOptimize(x = x * 31 + 7);
+            }
+        }
+        benchmarking::DoNotOptimize(x);
+    };
+    result = benchmark.Run(two_paths, settings);
+    std::cout << "Two paths: bimodality " << std::setprecision(2) << result.outliers_.bimodality_coefficient_
+              << (result.outliers_.bimodal_ ? " (bimodal, modes preserved)" : "") << ", rejected "
+              << result.outliers_.rejected_number_ << '\n';
+    std::cout << std::defaultfloat << std::setprecision(6);
+    
+    // Adaptive runs check convergence of median/p99 intervals on kept samples
+    settings.cycles_number_ = 200000;
+    settings.target_relative_ci_ = 0.01;
+    settings.max_time_budget_ = std::chrono::milliseconds{200};
+    settings.outliers_.enabled_ = false;
+    auto unfiltered = benchmark.RunAdaptive(stalled, settings);
+    settings.outliers_.enabled_ = true;
+    auto filtered = benchmark.RunAdaptive(stalled, settings);
+    std::cout << "Adaptive samples: " << unfiltered.samples_number_ << (unfiltered.converged_ ? " (converged)" : "")
+              << " unfiltered, " << filtered.samples_number_ << (filtered.converged_ ? " (converged)" : "")
+              << " filtered\n";
+}
+
+void demonstrate_barrier_comparison() {
+    std::cout << "\n=== Barrier Types Comparison ===\n";
+    
+    using AutoBenchmark = benchmarking::TSCBenchmarking<false, benchmarking::Barrier::kAuto>;
+    
+    AutoBenchmark benchmark{};
+    benchmark.Initialize();
+    
+    // Initialize() pinned thread - sweep every TSCClock specialization on the same core
+    auto costs = benchmarking::MeasureBarrierCosts();
+    benchmarking::PrintBarrierCosts(std::cout, costs, benchmark.GetCalibration());
+    std::cout << "Auto barrier selected: " << benchmarking::details::ToString(benchmarking::details::SelectFence()) << "\n";
+    
+    AutoBenchmark::Settings settings{};
+    settings.cycles_number_ = 1000;
+    settings.cpu_ = 0;
+    settings.overhead_correction_ = benchmarking::OverheadCorrection::kSubtractMin;
+    auto result = benchmark.Run([]() {
+        int x = 42;
+        benchmarking::DoNotOptimize(x);
+        return x * x + 1;
+    }, settings);
+    std::cout << "Auto barrier run: " << result.corrected_time_ << " cycles (" << result.corrected_time_ns_.count()
+              << " ns) with " << result.applied_overhead_ << " cycles overhead subtracted\n";
+}
+
+void demonstrate_cpu_migration_detection() {
+    std::cout << "\n=== CPU Migration Detection ===\n";
+    
+    using SafeBenchmark = benchmarking::TSCBenchmarking<true, benchmarking::Barrier::kRdtscp>;
+    
+    SafeBenchmark benchmark{};
+    benchmark.Initialize();
+    
+    auto code_with_potential_migration = []() {
+        // Simulate some work that might trigger CPU migration
+        int sum = 0;
+        for (int i = 0; i < 1000; ++i) {
+            benchmarking::DoNotOptimize(sum += i);
+        }
+        return sum;
+    };
+    
+    SafeBenchmark::Settings settings{};
+    settings.cycles_number_ = 500;
+    settings.cpu_ = 0;
+    
+    auto result = benchmark.Run(code_with_potential_migration, settings);
+    
+    std::cout << "With CPU migration detection:\n";
+    std::cout << "  Time: " << result.time_ << " cycles (" << result.time_ns_.count() << " ns)\n";
+    std::cout << "  (Invalid measurements due to CPU migration are automatically discarded)\n";
+}
+
+void demonstrate_memory_operations() {
+    std::cout << "\n=== Memory Operations Benchmark ===\n";
+    
+    using Benchmark = benchmarking::TSCBenchmarking<false, benchmarking::Barrier::kOneCpuId>;
+    
+    Benchmark benchmark{};
+    benchmark.Initialize();
+    
+    // Prepare test data
+    std::vector<int> data(1000);
+    std::iota(data.begin(), data.end(), 0);
+    
+    Benchmark::Settings settings{};
+    settings.cycles_number_ = 100;
+    settings.cpu_ = 0;
+    settings.cache_warmup_cycles_number_ = 50;
+    
+    // Test different memory access patterns
+    
+    // Sequential access
+    auto sequential_access = [&data]() {
+        int sum = 0;
+        for (size_t i = 0; i < data.size(); ++i) {
+            sum += data[i];
+        }
+        return sum;
+    };
+    
+    auto result1 = benchmark.Run(sequential_access, settings);
+    std::cout << "Sequential memory access: " << result1.time_ << " cycles (" << result1.time_ns_.count() << " ns)\n";
+    
+    // Random access
+    std::vector<size_t> indices(data.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    std::random_device rd;
+    std::mt19937 g(rd());
+    std::shuffle(indices.begin(), indices.end(), g);
+    
+    auto random_access = [&data, &indices]() {
+        int sum = 0;
+        for (size_t idx : indices) {
+            sum += data[idx];
+        }
+        return sum;
+    };
+    
+    auto result2 = benchmark.Run(random_access, settings);
+    std::cout << "Random memory access:    " << result2.time_ << " cycles (" << result2.time_ns_.count() << " ns)\n";
+    
+    // Cache line traversal
+    auto cache_line_access = [&data]() {
+        int sum = 0;
+        for (size_t i = 0; i < data.size(); i += 16) { // Assume 64-byte cache lines, 4-byte ints
+            sum += data[i];
+        }
+        return sum;
+    };
+    
+    auto result3 = benchmark.Run(cache_line_access, settings);
+    std::cout << "Cache line access:       " << result3.time_ << " cycles (" << result3.time_ns_.count() << " ns)\n";
+}
+
+void demonstrate_fixture_hooks() {
+    std::cout << "\n=== Fixture Setup and Teardown ===\n";
+
+    using Benchmark = benchmarking::TSCBenchmarking<false, benchmarking::Barrier::kOneCpuId>;
+
+    Benchmark benchmark{};
+    benchmark.Initialize();
+
+    Benchmark::Settings settings{};
+    settings.cycles_number_ = 1000;
+    settings.cpu_ = 0;
+    settings.cache_warmup_cycles_number_ = 100;
+
+    // Sorting consumes its input - setup reshuffles it outside of timed region
+    std::vector<int> data(256);
+    std::iota(data.begin(), data.end(), 0);
+    std::mt19937 g(42);
+    auto sort_result = benchmark.Run([&data, &g]() { std::shuffle(data.begin(), data.end(), g); },
+                                     [&data]() { std::sort(data.begin(), data.end()); },
+                                     []() {}, settings);
+    std::cout << "Sort of 256 shuffled ints:  " << sort_result.corrected_time_ << " cycles ("
+              << sort_result.corrected_time_ns_.count() << " ns)\n";
+
+    // Setup returns per-sample input, teardown restores state
+    std::vector<int> values(4096, 1);
+    std::uniform_int_distribution<std::size_t> index(0, values.size() - 1);
+    auto erase_result = benchmark.Run([&g, &index]() { return index(g); },
+                                      [&values](std::size_t i) { values.erase(values.begin() + static_cast<std::ptrdiff_t>(i)); },
+                                      [&values](std::size_t i) { values.insert(values.begin() + static_cast<std::ptrdiff_t>(i), 1); },
+                                      settings);
+    std::cout << "Erase at random position:   " << erase_result.corrected_time_ << " cycles ("
+              << erase_result.corrected_time_ns_.count() << " ns)\n";
+}
+
+void demonstrate_cache_states() {
+    std::cout << "\n=== Cache State Control ===\n";
+    
+    using Benchmark = benchmarking::TSCBenchmarking<false, benchmarking::Barrier::kOneCpuId>;
+    
+    Benchmark::Settings settings{};
+    settings.cycles_number_ = 200;
+    settings.cpu_ = 0;
+    settings.cache_warmup_cycles_number_ = 10;
+    settings.record_samples_ = true;
+    settings.overhead_correction_ = benchmarking::OverheadCorrection::kSubtractMin;
+    
+    Benchmark benchmark{};
+    benchmark.Initialize(settings);
+    
+    std::vector<int> data(16 * 1024);
+    std::iota(data.begin(), data.end(), 0);
+    auto sum_data = [&data]() {
+        int sum = 0;
+        for (size_t i = 0; i < data.size(); i += 16) {
+            sum += data[i];
+        }
+        return sum;
+    };
+    
+    settings.flush_regions_ = {{data.data(), data.size() * sizeof(int)}};
+    settings.thrash_bytes_ = 64u << 20;     // explicit size - LLC-based default may be huge on servers
+    for (auto state : {benchmarking::CacheState::kWarm, benchmarking::CacheState::kColdFlush,
+                       benchmarking::CacheState::kColdThrash, benchmarking::CacheState::kTlbCold}) {
+        settings.cache_state_ = state;
+        auto result = benchmark.Run(sum_data, settings);
+        std::cout << "  " << std::left << std::setw(12) << benchmarking::ToString(result.cache_state_) << std::right
+                  << " median " << result.corrected_distribution_.median_ << " cycles\n";
+    }
+}
+
+void demonstrate_numa_arena() {
+    std::cout << "\n=== NUMA-Local Arena ===\n";
+    
+    using Benchmark = benchmarking::TSCBenchmarking<false, benchmarking::Barrier::kOneCpuId>;
+    
+    constexpr std::size_t kElements = 1 << 20;
+    for (auto placement : {benchmarking::NodePlacement::kLocal, benchmarking::NodePlacement::kRemote}) {
+        Benchmark::Settings settings{};
+        settings.cycles_number_ = 100;
+        settings.cpu_ = 0;
+        settings.record_samples_ = true;
+        settings.overhead_correction_ = benchmarking::OverheadCorrection::kSubtractMin;
+        settings.arena_bytes_ = kElements * sizeof(std::uint32_t);
+        settings.arena_placement_ = placement;
+        
+        Benchmark benchmark{};
+        benchmark.Initialize(settings);
+        
+        // Fixture lives in prefaulted, node-bound arena memory
+        std::vector<std::uint32_t, benchmarking::ArenaAllocator<std::uint32_t>> next(
+            kElements, 0, benchmarking::ArenaAllocator<std::uint32_t>{&benchmark.GetArena()});
+        for (std::size_t i = 0; i < kElements; ++i) {
+            next[i] = static_cast<std::uint32_t>((i * 4099 + 1) % kElements);
+        }
+        auto walk = [&next]() {
+            std::uint32_t index = 0;
+            for (std::size_t i = 0; i < 4096; ++i) {
+                index = next[index];
+            }
+            return index;
+        };
+        
+        auto result = benchmark.Run(walk, settings);
+        std::cout << "  " << benchmarking::ToString(placement) << " node " << benchmark.GetArena().Node()
+                  << ": median " << result.corrected_distribution_.median_ / 4096.0 << " cycles per access\n";
+    }
+}
+
+void demonstrate_complexity_sweep() {
+    std::cout << "\n=== Input Size Sweep ===\n";
+    
+    using Benchmark = benchmarking::TSCBenchmarking<false, benchmarking::Barrier::kOneCpuId>;
+    
+    Benchmark::Settings settings{};
+    settings.cycles_number_ = 50;
+    settings.cpu_ = 0;
+    settings.cache_warmup_cycles_number_ = 5;
+    settings.overhead_correction_ = benchmarking::OverheadCorrection::kSubtractMin;
+    
+    Benchmark benchmark{};
+    benchmark.Initialize(settings);
+    
+    // Factory builds input outside of timed region, returned code is measured
+    auto make_random_walk = [](std::size_t n) {
+        std::vector<std::uint32_t> next(n);
+        std::iota(next.begin(), next.end(), 0);
+        std::shuffle(next.begin(), next.end(), std::mt19937{42});
+        return [next = std::move(next)]() {
+            std::uint32_t index = 0;
+            for (std::size_t i = 0; i < next.size(); ++i) {
+                index = next[index];
+            }
+            return index;
+        };
+    };
+    
+    auto sweep = benchmarking::RunComplexity(benchmark, make_random_walk, benchmarking::GeometricRange(1 << 8, 1 << 20, 4),
+                                             settings, sizeof(std::uint32_t));
+    for (const auto& point : sweep.points_) {
+        std::cout << "  n=" << std::setw(8) << point.size_ << ": " << std::fixed << std::setprecision(2)
+                  << point.per_element_ << " cycles/element (" << point.per_element_ns_.count() << " ns)"
+                  << std::defaultfloat << std::setprecision(6)
+                  << (point.cache_level_ ? "  L" + std::to_string(point.cache_level_) : std::string{"  memory"}) << "\n";
+    }
+    std::cout << "Best fit: " << benchmarking::ToString(sweep.fit_.complexity_) << " (rms " << sweep.fit_.rms_ << ")\n";
+    for (const auto& inflection : sweep.inflections_) {
+        std::cout << "  Leaving L" << inflection.cache_.level_ << " between n=" << inflection.size_before_
+                  << " and n=" << inflection.size_after_ << ": x" << inflection.cost_ratio_
+                  << (inflection.significant_ ? " per element\n" : " per element (not significant)\n");
+    }
+    
+    // Code invoked with size directly (void(std::size_t) form)
+    std::vector<std::uint32_t> buffer(1 << 16);
+    auto fill = benchmarking::RunComplexity(benchmark, [&buffer](std::size_t n) {
+        std::fill_n(buffer.begin(), n, 1u);
+        benchmarking::ClobberMemory();
+    }, benchmarking::GeometricRange(1 << 8, 1 << 16, 4), settings, sizeof(std::uint32_t));
+    std::cout << "Fill best fit: " << benchmarking::ToString(fill.fit_.complexity_) << "\n";
+}
+
+void demonstrate_batched_measurement() {
+    std::cout << "\n=== Batched Measurement ===\n";
+    
+    using Benchmark = benchmarking::TSCBenchmarking<false, benchmarking::Barrier::kOneCpuId>;
+    
+    Benchmark benchmark{};
+    benchmark.Initialize();
+    
+    // Single atomic increment is far cheaper than the fenced timestamp pair around it
+    std::atomic<std::uint64_t> counter{0};
+    auto increment = [&counter]() {
+        counter.fetch_add(1, std::memory_order_relaxed);
+    };
+    
+    Benchmark::Settings settings{};
+    settings.cycles_number_ = 1000;
+    settings.cpu_ = 0;
+    settings.overhead_correction_ = benchmarking::OverheadCorrection::kSubtractMin;
+    
+    auto single = benchmark.Run(increment, settings);
+    auto batched = benchmark.RunBatched<64>(increment, settings);
+    
+    std::cout << "Atomic increment, 1 op/sample:   " << single.per_op_time_ << " cycles/op\n";
+    std::cout << "Atomic increment, 64 ops/sample: " << batched.per_op_time_ << " cycles/op ("
+              << batched.per_op_time_ns_.count() << " ns/op, amortized overhead "
+              << batched.amortized_overhead_ << " cycles/op)\n";
+}
+
+void demonstrate_latency_throughput() {
+    std::cout << "\n=== Latency vs Throughput ===\n";
+    
+    using Benchmark = benchmarking::TSCBenchmarking<false, benchmarking::Barrier::kOneCpuId>;
+    
+    Benchmark::Settings settings{};
+    settings.cycles_number_ = 1000;
+    settings.record_samples_ = true;
+    settings.overhead_correction_ = benchmarking::OverheadCorrection::kSubtractMin;
+    
+    Benchmark benchmark{};
+    benchmark.Initialize(settings);
+    
+    // Every division depends on previous one - invocations cannot overlap
+    std::uint64_t chain = 1ULL << 62;
+    auto dependent = [&chain]() {
+        chain = chain / 3 + (1ULL << 62);
+    };
+    // Independent divisions of fresh input - out-of-order core overlaps them
+    auto independent = []() {
+        std::uint64_t value = 1ULL << 62;
+        benchmarking::DoNotOptimize(value);
+        return value / 3;
+    };
+    
+    auto print = [](const char* name, const Benchmark::ThroughputResult& result) {
+        std::cout << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(2)
+                  << "latency " << std::setw(7) << result.latency_time_ << " cycles, throughput "
+                  << std::setw(6) << result.throughput_time_ << " cycles/op, overlap " << result.overlap_ << "x\n";
+        std::cout << std::defaultfloat << std::setprecision(6);
+    };
+    print("Dependent division:", benchmark.RunThroughput(dependent, settings));
+    print("Independent division:", benchmark.RunThroughput(independent, settings));
+    benchmarking::DoNotOptimize(chain);
+}
+
+void demonstrate_parallel_scaling() {
+    std::cout << "\n=== Parallel Scaling ===\n";
+    
+    using Benchmark = benchmarking::TSCBenchmarking<false, benchmarking::Barrier::kOneCpuId>;
+    
+    Benchmark benchmark{};
+    benchmark.Initialize();
+    
+    // Every worker hits the same cache line - throughput stops scaling with threads
+    std::atomic<std::uint64_t> shared_counter{0};
+    auto contended_increment = [&shared_counter]() {
+        shared_counter.fetch_add(1, std::memory_order_relaxed);
+    };
+    
+    Benchmark::Settings settings{};
+    settings.cycles_number_ = 10000;
+    settings.overhead_correction_ = benchmarking::OverheadCorrection::kSubtractMin;
+    
+    auto curve = benchmark.RunParallel(contended_increment, settings);
+    for (const auto& point : curve) {
+        std::cout << std::setw(3) << point.threads_number_ << " threads: "
+                  << std::setw(12) << std::fixed << std::setprecision(0) << point.aggregate_throughput_ << " ops/s, "
+                  << std::setprecision(2) << point.scaling_efficiency_ * 100 << "% of linear, median "
+                  << point.threads_.front().distribution_.median_ << " cycles\n";
+    }
+    std::cout << std::defaultfloat << std::setprecision(6);
+}
+
+void demonstrate_performance_counters() {
+    std::cout << "\n=== Hardware Performance Counters ===\n";
+    
+    using Benchmark = benchmarking::TSCBenchmarking<false, benchmarking::Barrier::kOneCpuId>;
+    
+    Benchmark benchmark{};
+    benchmark.Initialize();
+    
+    benchmarking::PerfCounters counters{};
+    if (!counters.Open()) {
+        std::cout << "Performance counters are not available on this system\n";
+        return;
+    }
+    
+    std::vector<int> data(4096);
+    std::iota(data.begin(), data.end(), 0);
+    auto sum_array = [&data]() {
+        long sum = 0;
+        for (int value : data) {
+            sum += value;
+        }
+        return sum;
+    };
+    
+    Benchmark::Settings settings{};
+    settings.cycles_number_ = 1000;
+    settings.cpu_ = 0;
+    settings.overhead_correction_ = benchmarking::OverheadCorrection::kSubtractMin;
+    
+    auto result = benchmark.Run(sum_array, settings, counters);
+    for (std::size_t i = 0; i < result.counters_.events_.size(); ++i) {
+        std::cout << "  " << std::setw(14) << std::left << benchmarking::ToString(result.counters_.events_[i])
+                  << std::right << result.counters_.per_call_[i] << " per call\n";
+    }
+    std::cout << "  IPC: " << result.counters_.Ipc() << (result.counters_.valid_ ? "" : " (counters multiplexed)") << "\n";
+}
+
+void demonstrate_minimal_overhead() {
+    std::cout << "\n=== Minimal Overhead Measurement ===\n";
+    
+    using Benchmark = benchmarking::TSCBenchmarking<false, benchmarking::Barrier::kOneCpuId>;
+    
+    Benchmark benchmark{};
+    benchmark.Initialize();
+    
+    // For critical applications where you need minimal measurement overhead
+    auto critical_code = []() {
+        int x = 1;
+        benchmarking::DoNotOptimize(x);
+        return x << 1;
+    };
+    
+    // Single measurement with minimal overhead
+    auto raw_time = benchmark.MeasureTime(critical_code);
+    
+    std::cout << "Minimal overhead measurement: " << raw_time << " cycles ("
+              << benchmark.GetCalibration().ToNanos(raw_time).count() << " ns, raw)\n";
+    std::cout << "Note: This includes TSC overhead, use Run() for overhead-corrected results\n";
+}
+
+void demonstrate_static_settings() {
+    std::cout << "\n=== Compile-Time Settings ===\n";
+    
+    using Benchmark = benchmarking::TSCBenchmarking<true, benchmarking::Barrier::kRdtscp>;
+    // 10000 samples, 1000 warmup invocations, minimum overhead subtracted, at most 100 retries per sample
+    using Config = benchmarking::StaticSettings<10000, 1000, benchmarking::OverheadCorrection::kSubtractMin, true, 100>;
+    
+    Benchmark benchmark{};
+    benchmark.Initialize(Benchmark::MakeSettings<Config>());
+    
+    std::uint64_t counter = 0;
+    auto increment = [&counter]() { benchmarking::DoNotOptimize(++counter); };
+    
+    auto print = [](const char* name, const Benchmark::Result& result) {
+        std::cout << std::left << std::setw(13) << name << std::right << "median "
+                  << result.corrected_distribution_.median_ << " cycles, p99 " << result.corrected_distribution_.p99_
+                  << " cycles, discarded " << result.discarded_number_ << " (" << std::fixed << std::setprecision(2)
+                  << result.discard_rate_ * 100.0 << "%, " << result.migrations_number_ << " migrations)"
+                  << (result.aborted_ ? " aborted" : "") << '\n';
+        std::cout << std::defaultfloat << std::setprecision(6);
+    };
+    print("Run():", benchmark.Run(increment, Benchmark::MakeSettings<Config>()));
+    print("RunStatic():", benchmark.RunStatic<Config>(increment));
+}
+
+void demonstrate_production_probes() {
+    std::cout << "\n=== Production Probes ===\n";
+
+    benchmarking::TSCCalibration calibration = benchmarking::TSCCalibration::Calibrate();
+    std::vector<int> data(256);
+    std::iota(data.begin(), data.end(), 0);
+
+    auto handle_request = [&data](int request) {
+        TSC_PROBE("handle_request");
+        return std::accumulate(data.begin(), data.end(), request);
+    };
+
+    // Reporter merges per-thread histograms without stopping request threads
+    benchmarking::ProbeReporter reporter{};
+    reporter.Start(std::chrono::milliseconds{50}, [&calibration](const std::vector<benchmarking::HistogramSnapshot>& snapshots) {
+        for (const auto& snapshot : snapshots) {
+            std::cout << "  [reporter] " << snapshot.name_ << ": " << snapshot.count_ << " calls, p99 "
+                      << calibration.ToNanos(snapshot.Quantile(0.99)).count() << " ns\n";
+        }
+    });
+
+    // Bursts of requests separated by idle time, as in a server
+    std::thread worker([&handle_request]() {
+        for (int i = 0; i < 200000; ++i) {
+            benchmarking::DoNotOptimize(handle_request(i));
+        }
+    });
+    for (int burst = 0; burst < 4; ++burst) {
+        for (int i = 0; i < 50000; ++i) {
+            benchmarking::DoNotOptimize(handle_request(i));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds{60});
+    }
+    worker.join();
+    reporter.Stop();
+
+    for (const auto& snapshot : benchmarking::ProbeRegistry::Instance().Snapshot()) {
+        std::cout << snapshot.name_ << ": " << snapshot.count_ << " calls, mean "
+                  << calibration.ToFractionalNanos(snapshot.Mean()).count() << " ns, p50 "
+                  << calibration.ToNanos(snapshot.Quantile(0.5)).count() << " ns, p99 "
+                  << calibration.ToNanos(snapshot.Quantile(0.99)).count() << " ns, max "
+                  << calibration.ToNanos(snapshot.max_).count() << " ns\n";
+    }
+}
+
+void demonstrate_trace_ring() {
+    std::cout << "\n=== Pipeline Trace Ring ===\n";
+
+    enum Stage : std::uint32_t { kReceived, kParsed, kProcessed };
+    benchmarking::TSCCalibration calibration = benchmarking::TSCCalibration::Calibrate();
+    constexpr int kMessages = 10000;
+
+    // Traced thread only writes into ring, drainer thread writes file
+    benchmarking::TraceRing<> ring{};
+    benchmarking::TraceDrainer<> drainer{};
+    if (!drainer.Start(ring, "/tmp/tsc_pipeline.trace", calibration)) {
+        return;
+    }
+    std::vector<int> payload(64, 1);
+    for (int message = 0; message < kMessages; ++message) {
+        ring.Record(kReceived);
+        benchmarking::DoNotOptimize(std::accumulate(payload.begin(), payload.end(), message));
+        ring.Record(kParsed);
+        std::sort(payload.begin(), payload.end());
+        ring.Record(kProcessed);
+    }
+    drainer.Stop();
+
+    // Offline: reconstruct per-stage latency from mapped file
+    benchmarking::TraceReader reader{};
+    if (!reader.Open("/tmp/tsc_pipeline.trace")) {
+        return;
+    }
+    std::vector<benchmarking::TimePoint> parse, process;
+    benchmarking::TimePoint received = 0, parsed = 0;
+    for (const benchmarking::TraceEvent& event : reader.Events()) {
+        switch (event.event_id_) {
+            case kReceived: received = event.tsc_; break;
+            case kParsed: parsed = event.tsc_; parse.push_back(parsed - received); break;
+            case kProcessed: process.push_back(event.tsc_ - parsed); break;
+            default: break;
+        }
+    }
+    auto parse_distribution = benchmarking::ComputeDistribution(parse);
+    auto process_distribution = benchmarking::ComputeDistribution(process);
+    std::cout << reader.Events().size() << " events, " << reader.Header().dropped_ << " dropped\n";
+    std::cout << "  received -> parsed:    median " << calibration.ToNanos(parse_distribution.median_).count()
+              << " ns, p99 " << calibration.ToNanos(parse_distribution.p99_).count() << " ns\n";
+    std::cout << "  parsed -> processed:   median " << calibration.ToNanos(process_distribution.median_).count()
+              << " ns, p99 " << calibration.ToNanos(process_distribution.p99_).count() << " ns\n";
+}
+
+void demonstrate_binary_samples() {
+    std::cout << "\n=== Binary Sample File ===\n";
+
+    using Benchmark = benchmarking::TSCBenchmarking<false, benchmarking::Barrier::kLFence>;
+
+    Benchmark::Settings settings{};
+    settings.cycles_number_ = 100000;
+    settings.cpu_ = 0;
+    settings.record_samples_ = true;
+    settings.noise_probe_time_ = std::chrono::microseconds{0};
+
+    Benchmark benchmark{};
+    benchmark.Initialize(settings);
+
+    // Long history is streamed run by run, never held in memory as a whole
+    benchmarking::SampleWriter writer{};
+    if (!writer.Create("/tmp/tsc_history.tscs",
+                       benchmarking::HostInfo::Collect(benchmark.GetCalibration(), Benchmark::kBarrier, Benchmark::kCheckCpuMigration),
+                       "multiply", settings.cpu_)) {
+        return;
+    }
+    for (int run = 0; run < 10; ++run) {
+        auto result = benchmark.Run([]() {
+            int x = 42;
+            benchmarking::DoNotOptimize(x);
+            return x * x + 1;
+        }, settings);
+        writer.Append(result.samples_);
+    }
+    const std::uint64_t samples_number = writer.SamplesNumber();
+    const std::size_t bytes = writer.Bytes();
+    writer.Close();
+    std::cout << samples_number << " samples in " << bytes << " bytes ("
+              << static_cast<double>(bytes) / static_cast<double>(samples_number) << " bytes/sample)\n";
+
+    benchmarking::SampleReader reader{};
+    if (!reader.Open("/tmp/tsc_history.tscs")) {
+        return;
+    }
+    benchmarking::TimePoint min = std::numeric_limits<benchmarking::TimePoint>::max(), max = 0;
+    reader.ForEach([&min, &max](benchmarking::TimePoint sample) {
+        min = std::min(min, sample);
+        max = std::max(max, sample);
+    });
+    std::cout << reader.Header().name_ << " on CPU " << reader.Header().cpu_ << " at "
+              << reader.Header().tsc_hz_ / 1e6 << " MHz: min " << min << ", max " << max << " cycles\n";
+}
+
+void demonstrate_core_classes() {
+    std::cout << "\n=== Hybrid Core Classes ===\n";
+    
+    using Benchmark = benchmarking::TSCBenchmarking<false, benchmarking::Barrier::kOneCpuId>;
+    
+    Benchmark::Settings settings{};
+    settings.cycles_number_ = 5000;
+    settings.record_samples_ = true;
+    settings.overhead_correction_ = benchmarking::OverheadCorrection::kSubtractMin;
+    
+    Benchmark benchmark{};
+    benchmark.Initialize(settings);
+    
+    // One P-core and one E-core on hybrid parts, a single CPU otherwise
+    auto runs = benchmarking::RunOnCoreClass(benchmark, []() {
+        std::uint64_t hash = 1469598103934665603ULL;
+        for (std::uint64_t i = 0; i < 64; ++i) {
+            hash = (hash ^ i) * 1099511628211ULL;
+        }
+        return hash;
+    }, benchmarking::CoreClass::kOneOfEach, settings);
+    for (const auto& run : runs) {
+        std::cout << "CPU " << run.cpu_ << " (" << benchmarking::ToString(run.core_type_) << "): median "
+                  << run.result_.corrected_distribution_.median_ << " cycles (overhead " << run.overhead_ << ")\n";
+    }
+    for (const auto& summary : benchmarking::GroupByCoreType(runs)) {
+        std::cout << std::left << std::setw(8) << benchmarking::ToString(summary.core_type_) << std::right
+                  << summary.cpus_.size() << " CPUs, median " << summary.median_time_ << " cycles (range "
+                  << summary.min_time_ << "-" << summary.max_time_ << ")\n";
+    }
+}
+
+void demonstrate_loaded_latency() {
+    std::cout << "\n=== Loaded Latency ===\n";
+    
+    using Benchmark = benchmarking::TSCBenchmarking<false, benchmarking::Barrier::kOneCpuId>;
+    
+    Benchmark::Settings settings{};
+    settings.cycles_number_ = 2000;
+    settings.record_samples_ = true;
+    settings.overhead_correction_ = benchmarking::OverheadCorrection::kSubtractMin;
+    
+    Benchmark benchmark{};
+    benchmark.Initialize(settings);
+    
+    // Pointer chase over 4 MiB - misses L2, sensitive to LLC and memory contention
+    constexpr std::size_t kLines = (4 << 20) / 64;
+    std::vector<std::size_t> next(kLines * 8);
+    std::vector<std::size_t> order(kLines);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin() + 1, order.end(), std::mt19937_64{42});
+    for (std::size_t i = 0; i < kLines; ++i) {
+        next[order[i] * 8] = order[(i + 1) % kLines] * 8;
+    }
+    std::size_t position = 0;
+    auto chase = [&next, &position]() {
+        for (int i = 0; i < 16; ++i) {
+            position = next[position];
+        }
+    };
+    
+    benchmarking::LoadSettings load{};
+    load.kind_ = benchmarking::AggressorKind::kBandwidth;
+    for (int cpu : benchmarking::details::GetPlacementCpuList()) {
+        if (cpu != settings.cpu_) {
+            load.cpus_.push_back(cpu);
+        }
+    }
+    if (load.cpus_.empty()) {
+        std::cout << "Single CPU - no room for aggressors, measuring idle baseline only\n";
+        load.intensities_ = {0.0};
+    } else {
+        load.cpus_.resize(std::min<std::size_t>(load.cpus_.size(), 3));
+    }
+    
+    std::cout << std::left << std::setw(12) << "Intensity" << std::setw(12) << "Aggressors" << std::right
+              << std::setw(14) << "Load MB/s" << std::setw(16) << "Median cycles" << '\n';
+    for (const auto& point : benchmarking::RunLoaded(benchmark, chase, load, settings)) {
+        std::cout << std::left << std::setw(12) << point.intensity_ << std::setw(12) << point.aggressors_number_
+                  << std::right << std::fixed << std::setprecision(0) << std::setw(14)
+                  << point.aggressor_throughput_ / 1e6 << std::setw(16)
+                  << point.result_.corrected_distribution_.median_ << '\n';
+        std::cout << std::defaultfloat << std::setprecision(6);
+    }
+    benchmarking::DoNotOptimize(position);
+}
+
+void demonstrate_virtualized_clock() {
+    std::cout << "\n=== Clock Sources ===\n";
+    
+    const benchmarking::details::CpuInfo& cpu_info = benchmarking::details::CpuInfo::Instance();
+    const benchmarking::EnvironmentReport environment = benchmarking::CheckEnvironment(0);
+    std::cout << "Hypervisor:   " << (environment.hypervisor_.empty() ? "none" : environment.hypervisor_)
+              << (cpu_info.IsKvmClockStable() ? " (stable kvm-clock)" : "") << "\n";
+    std::cout << "Clocksource:  " << (environment.clocksource_.empty() ? "unknown" : environment.clocksource_) << "\n";
+    std::cout << "TSC reliable: " << (environment.tsc_reliable_ ? "yes" : "no - prefer VdsoClock") << "\n";
+    
+    auto code = []() {
+        std::uint64_t sum = 0;
+        for (std::uint64_t i = 0; i < 200; ++i) {
+            benchmarking::DoNotOptimize(sum += i * i);
+        }
+        return sum;
+    };
+    
+    // Same code on both backends - results are comparable in nanoseconds
+    using TscBenchmark = benchmarking::TSCBenchmarking<false, benchmarking::Barrier::kAuto>;
+    using VdsoBenchmark = benchmarking::TSCBenchmarking<false, benchmarking::Barrier::kAuto, benchmarking::VdsoClock<>>;
+    
+    TscBenchmark::Settings tsc_settings{};
+    tsc_settings.cycles_number_ = 2000;
+    tsc_settings.cache_warmup_cycles_number_ = 1000;
+    tsc_settings.record_samples_ = true;
+    tsc_settings.overhead_correction_ = benchmarking::OverheadCorrection::kSubtractMin;
+    TscBenchmark tsc_benchmark{};
+    tsc_benchmark.Initialize(tsc_settings);
+    auto tsc_result = tsc_benchmark.Run(code, tsc_settings);
+    
+    VdsoBenchmark::Settings vdso_settings{};
+    vdso_settings.cycles_number_ = 2000;
+    vdso_settings.cache_warmup_cycles_number_ = 1000;
+    vdso_settings.record_samples_ = true;
+    vdso_settings.overhead_correction_ = benchmarking::OverheadCorrection::kSubtractMin;
+    VdsoBenchmark vdso_benchmark{};
+    vdso_benchmark.Initialize(vdso_settings);
+    auto vdso_result = vdso_benchmark.Run(code, vdso_settings);
+    
+    std::cout << "TSCClock:  median " << tsc_benchmark.GetCalibration().ToNanos(tsc_result.corrected_distribution_.median_).count()
+              << " ns (clock overhead " << tsc_result.overhead_ns_.count() << " ns)\n";
+    std::cout << "VdsoClock: median " << vdso_benchmark.GetCalibration().ToNanos(vdso_result.corrected_distribution_.median_).count()
+              << " ns (clock overhead " << vdso_result.overhead_ns_.count() << " ns)\n";
+}
+
+void demonstrate_coroutine_hops() {
+    std::cout << "\n=== Coroutine Resume Latency ===\n";
+    
+    using Benchmark = benchmarking::TSCBenchmarking<false, benchmarking::Barrier::kOneCpuId>;
+    
+    Benchmark benchmark{};
+    benchmark.Initialize();
+    // Run() pins thread; harness then runs on the same core
+    benchmark.Run(benchmarking::details::kEmptyCode, Benchmark::Settings{});
+    
+    benchmarking::FifoExecutor executor{};
+    auto result = benchmarking::MeasureCoroutineHops(executor, 100000, benchmark.GetCalibration());
+    std::cout << result.hops_number_ << " hops: raw resume median " << result.resume_.median_ << " cycles, corrected "
+              << result.corrected_resume_.median_ << " cycles (" << result.median_resume_ns_.count() << " ns), p99 "
+              << result.corrected_resume_.p99_ << " cycles, timing overhead " << result.overhead_ << " cycles\n";
+    std::cout << "Full hop (suspend, enqueue, resume, loop): " << result.hop_time_ << " cycles ("
+              << result.hop_time_ns_.count() << " ns)\n";
+}
+
+void display_cpu_info() {
+    std::cout << "\n=== CPU Information ===\n";
+    
+    const benchmarking::details::CpuInfo& cpu_info = benchmarking::details::CpuInfo::Instance();
+    
+    std::cout << "Vendor:                 " << cpu_info.Vendor() << "\n";
+    std::cout << "TSC supported:          " << (cpu_info.IsTscEnabled() ? "Yes" : "No") << "\n";
+    std::cout << "RDTSCP supported:       " << (cpu_info.IsRdtscpEnabled() ? "Yes" : "No") << "\n";
+    std::cout << "Invariant TSC:          " << (cpu_info.IsInvariantTscEnabled() ? "Yes" : "No") << "\n";
+    std::cout << "TSC from CPUID 0x15:    ";
+    if (cpu_info.TscHz() > 0.0) {
+        std::cout << cpu_info.TscHz() / 1e6 << " MHz (" << cpu_info.TscRatioNumerator() << "/"
+                  << cpu_info.TscRatioDenominator() << " x " << cpu_info.CrystalHz() / 1e6 << " MHz crystal)\n";
+    } else {
+        std::cout << "not enumerated\n";
+    }
+    std::cout << "Hybrid:                 " << (cpu_info.IsHybrid() ? "Yes" : "No") << "\n";
+    std::cout << "Hypervisor:             " << (cpu_info.IsHypervisorPresent() ? cpu_info.HypervisorVendor() : "none") << "\n";
+    for (const auto& cache : cpu_info.Caches()) {
+        static constexpr const char* kTypes[] = {"none", "data", "instruction", "unified"};
+        std::cout << "L" << cache.level_ << " " << std::left << std::setw(20) << kTypes[cache.type_ & 3] << std::right
+                  << cache.size_bytes_ / 1024 << " KiB, " << cache.ways_ << "-way, " << cache.line_bytes_ << " B lines\n";
+    }
+    for (const auto& cpu : benchmarking::details::GetCpuTopology()) {
+        std::cout << "CPU " << cpu.cpu_ << ": APIC id " << cpu.apic_id_ << ", package " << cpu.package_
+                  << ", core " << cpu.core_ << ", thread " << cpu.thread_ << ", "
+                  << benchmarking::ToString(benchmarking::GetCoreType(cpu.cpu_)) << "\n";
+    }
+    
+    // Display number of CPU cores
+    int cpu_cores = benchmarking::details::GetCpuCoreCount();
+    std::cout << "CPU cores available:    " << cpu_cores << "\n";
+}
+
+void demonstrate_environment_check() {
+    std::cout << "\n=== Environment Noise ===\n";
+
+    using Benchmark = benchmarking::TSCBenchmarking<false, benchmarking::Barrier::kOneCpuId>;
+
+    Benchmark benchmark{};
+    benchmark.Initialize();
+
+    const benchmarking::EnvironmentReport& environment = benchmark.GetEnvironment();
+    std::cout << "Governor:     " << (environment.governor_.empty() ? "unknown" : environment.governor_) << "\n";
+    std::cout << "Turbo:        " << (!environment.turbo_enabled_ ? "unknown" : *environment.turbo_enabled_ ? "on" : "off") << "\n";
+    std::cout << "Isolated:     " << (environment.isolated_ ? "yes" : "no")
+              << ", nohz_full: " << (environment.nohz_full_ ? "yes" : "no") << "\n";
+    std::cout << "SMT siblings: " << environment.smt_siblings_.size() << ", IRQs on CPU: " << environment.irqs_number_ << "\n";
+
+    Benchmark::Settings settings{};
+    settings.cycles_number_ = 1000;
+    settings.cpu_ = 0;
+    settings.noise_probe_time_ = std::chrono::milliseconds{20};
+
+    auto result = benchmark.Run([]() {
+        int x = 42;
+        benchmarking::DoNotOptimize(x);
+        return x * x + 1;
+    }, settings);
+    std::cout << "Noise score:  " << result.noise_score_ * 100.0 << "% (" << result.noise_.gaps_number_ << " gaps, longest "
+              << benchmark.GetCalibration().ToNanos(result.noise_.max_gap_).count() << " ns)"
+              << (result.noisy_ ? " - result rejected as noisy\n" : "\n");
+}
+
+int main() {
+    std::cout << "TSC Benchmark Library - Advanced Examples\n";
+    std::cout << "=========================================\n";
+    
+    display_cpu_info();
+    
+    try {
+        demonstrate_environment_check();
+        demonstrate_basic_usage();
+        demonstrate_latency_distribution();
+        demonstrate_adaptive_sampling();
+        demonstrate_outlier_filtering();
+        demonstrate_barrier_comparison();
+        demonstrate_virtualized_clock();
+        demonstrate_cpu_migration_detection();
+        demonstrate_memory_operations();
+        demonstrate_fixture_hooks();
+        demonstrate_cache_states();
+        demonstrate_numa_arena();
+        demonstrate_complexity_sweep();
+        demonstrate_batched_measurement();
+        demonstrate_latency_throughput();
+        demonstrate_parallel_scaling();
+        demonstrate_core_classes();
+        demonstrate_loaded_latency();
+        demonstrate_performance_counters();
+        demonstrate_minimal_overhead();
+        demonstrate_static_settings();
+        demonstrate_coroutine_hops();
+        demonstrate_production_probes();
+        demonstrate_trace_ring();
+        demonstrate_binary_samples();
+        
+        std::cout << "\n=== All examples completed successfully! ===\n";
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    
+    return 0;
+} 
\ No newline at end of file
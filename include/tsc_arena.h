@@ -0,0 +1,280 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+// Linux system includes
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "utils/numa.h"
+#include "utils/types.h"
+
+namespace benchmarking {
+
+    /// Page size policy of arena
+    enum class ArenaPages {
+        kAuto,              ///< Reserved huge pages, then transparent huge pages, then small pages
+        kHugeTlb,           ///< Reserved huge pages (MAP_HUGETLB) only
+        kTransparent,       ///< Small-page mapping with madvise(MADV_HUGEPAGE)
+        kSmall              ///< Small pages only
+    };
+
+    /// NUMA node of arena memory relative to benchmark CPU
+    enum class NodePlacement {
+        kLocal,             ///< Node of CPU core
+        kRemote,            ///< Next online node after node of CPU core (local on single-node machines)
+        kAny                ///< No binding (kernel default policy)
+    };
+
+    /// Human-readable name of node placement
+    inline const char* ToString(NodePlacement placement) noexcept {
+        switch (placement) {
+            case NodePlacement::kLocal: return "local";
+            case NodePlacement::kRemote: return "remote";
+            case NodePlacement::kAny: return "any";
+        }
+        return "unknown";
+    }
+
+    /**
+     * @brief Prefaulted bump allocator over single huge-page backed, NUMA-bound mapping
+     *
+     * Memory is bound with mbind() before it is touched, then every page is written once,
+     * so neither first-touch faults nor page placement show up in measurements.
+     * Allocations are only released all together with Reset() or destruction.
+     *
+     * Example usage:
+     * @code
+     * Arena arena{};
+     * arena.Create(64 << 20, 0);
+     * auto* table = arena.AllocateArray<Entry>(1 << 20);
+     * std::vector<int, ArenaAllocator<int>> data(1024, 0, ArenaAllocator<int>{&arena});
+     * @endcode
+     */
+    class Arena {
+    public:
+        static constexpr std::size_t kHugePageSize = 2u << 20;
+
+        Arena() = default;
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        ~Arena() { Destroy(); }
+
+        /**
+         * @brief Map and prefault arena
+         * @param capacity Size in bytes (rounded up to page size)
+         * @param cpu CPU core whose NUMA node is used for placement
+         * @param placement Node placement relative to cpu
+         * @param pages Page size policy
+         * @return true if arena was mapped (binding failures are reported but not fatal)
+         */
+        bool Create(std::size_t capacity, int cpu, NodePlacement placement = NodePlacement::kLocal,
+                    ArenaPages pages = ArenaPages::kAuto);
+
+        /// Unmap arena
+        void Destroy() noexcept {
+            if (data_ != nullptr) {
+                munmap(data_, capacity_);
+            }
+            data_ = nullptr;
+            capacity_ = used_ = 0;
+        }
+
+        /**
+         * @brief Allocate bytes from arena
+         * @param size Size in bytes
+         * @param alignment Alignment (power of two)
+         * @return Pointer or nullptr if arena is exhausted
+         */
+        [[nodiscard]] void* Allocate(std::size_t size, std::size_t alignment = kCacheLineSize) noexcept {
+            std::size_t offset = (used_ + alignment - 1) & ~(alignment - 1);
+            if (data_ == nullptr || offset + size > capacity_) {
+                return nullptr;
+            }
+            used_ = offset + size;
+            return data_ + offset;
+        }
+
+        /// Allocate value-initialized array from arena (nullptr if arena is exhausted)
+        template<typename T>
+        [[nodiscard]] T* AllocateArray(std::size_t count) {
+            void* memory = Allocate(count * sizeof(T), std::max(alignof(T), kCacheLineSize));
+            if (memory == nullptr) {
+                return nullptr;
+            }
+            T* array = static_cast<T*>(memory);
+            std::uninitialized_value_construct_n(array, count);
+            return array;
+        }
+
+        /// Release all allocations (memory stays mapped and resident)
+        void Reset() noexcept { used_ = 0; }
+
+        /// Check if pointer belongs to arena
+        [[nodiscard]] bool Owns(const void* pointer) const noexcept {
+            auto address = static_cast<const std::byte*>(pointer);
+            return data_ != nullptr && address >= data_ && address < data_ + capacity_;
+        }
+
+        /// Check if arena is mapped
+        [[nodiscard]] bool IsCreated() const noexcept { return data_ != nullptr; }
+
+        /// Mapped size in bytes
+        [[nodiscard]] std::size_t Capacity() const noexcept { return capacity_; }
+
+        /// Allocated size in bytes
+        [[nodiscard]] std::size_t Used() const noexcept { return used_; }
+
+        /// Page size backing arena (kHugePageSize for reserved or transparent huge pages)
+        [[nodiscard]] std::size_t PageSize() const noexcept { return page_size_; }
+
+        /// True if arena is backed by reserved huge pages (MAP_HUGETLB)
+        [[nodiscard]] bool IsHugeTlb() const noexcept { return huge_tlb_; }
+
+        /// NUMA node arena is bound to (-1 if not bound)
+        [[nodiscard]] int Node() const noexcept { return node_; }
+
+    private:
+        std::byte* data_{nullptr};
+        std::size_t capacity_{0};
+        std::size_t used_{0};
+        std::size_t page_size_{0};
+        bool huge_tlb_{false};
+        int node_{-1};
+    };
+
+    /**
+     * @brief Standard allocator over Arena for containers of fixture data
+     *
+     * Falls back to global operator new when arena is missing or exhausted; deallocation
+     * of arena memory is a no-op.
+     */
+    template<typename T>
+    class ArenaAllocator {
+    public:
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        ArenaAllocator() noexcept = default;
+        explicit ArenaAllocator(Arena* arena) noexcept : arena_{arena} {}
+
+        template<typename U>
+        ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena_{other.GetArena()} {}
+
+        [[nodiscard]] T* allocate(std::size_t count) {
+            if (arena_ != nullptr) {
+                if (void* memory = arena_->Allocate(count * sizeof(T), std::max(alignof(T), kCacheLineSize))) {
+                    return static_cast<T*>(memory);
+                }
+            }
+            return static_cast<T*>(::operator new(count * sizeof(T)));
+        }
+
+        void deallocate(T* pointer, std::size_t) noexcept {
+            if (arena_ == nullptr || !arena_->Owns(pointer)) {
+                ::operator delete(pointer);
+            }
+        }
+
+        [[nodiscard]] Arena* GetArena() const noexcept { return arena_; }
+
+        template<typename U>
+        bool operator==(const ArenaAllocator<U>& other) const noexcept { return arena_ == other.GetArena(); }
+
+    private:
+        Arena* arena_{nullptr};
+    };
+
+
+    // Implementation
+    inline bool Arena::Create(std::size_t capacity, int cpu, NodePlacement placement, ArenaPages pages) {
+        Destroy();
+        const auto small_page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        const std::size_t huge_capacity = (capacity + kHugePageSize - 1) & ~(kHugePageSize - 1);
+        void* memory = MAP_FAILED;
+
+        if (pages == ArenaPages::kAuto || pages == ArenaPages::kHugeTlb) {
+            memory = mmap(nullptr, huge_capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (memory != MAP_FAILED) {
+                capacity_ = huge_capacity;
+                page_size_ = kHugePageSize;
+                huge_tlb_ = true;
+            } else if (pages == ArenaPages::kHugeTlb) {
+                std::cerr << "[Warning] Failed to map " << huge_capacity << " bytes of reserved huge pages: "
+                          << std::strerror(errno) << std::endl;
+                return false;
+            }
+        }
+        if (memory == MAP_FAILED && pages != ArenaPages::kSmall) {
+            // Over-map so that arena can start on huge page boundary
+            const std::size_t mapped = huge_capacity + kHugePageSize;
+            void* raw = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (raw != MAP_FAILED) {
+                auto begin = reinterpret_cast<std::uintptr_t>(raw);
+                auto aligned = (begin + kHugePageSize - 1) & ~(kHugePageSize - 1);
+                if (aligned > begin) {
+                    munmap(raw, aligned - begin);
+                }
+                munmap(reinterpret_cast<void*>(aligned + huge_capacity), begin + mapped - aligned - huge_capacity);
+                memory = reinterpret_cast<void*>(aligned);
+                capacity_ = huge_capacity;
+                huge_tlb_ = false;
+                page_size_ = madvise(memory, capacity_, MADV_HUGEPAGE) == 0 ? kHugePageSize : small_page;
+                if (page_size_ != kHugePageSize) {
+                    std::cerr << "[Warning] Transparent huge pages are not available - arena uses small pages" << std::endl;
+                }
+            }
+        }
+        if (memory == MAP_FAILED) {
+            capacity_ = (capacity + small_page - 1) & ~(small_page - 1);
+            memory = mmap(nullptr, capacity_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            page_size_ = small_page;
+            huge_tlb_ = false;
+        }
+        if (memory == MAP_FAILED) {
+            std::cerr << "[Warning] Failed to map arena of " << capacity << " bytes: " << std::strerror(errno) << std::endl;
+            capacity_ = 0;
+            return false;
+        }
+        data_ = static_cast<std::byte*>(memory);
+
+        // Bind before first touch so that pages are allocated on target node
+        node_ = -1;
+        if (placement != NodePlacement::kAny) {
+            const int local = details::GetCpuNumaNode(cpu);
+            int node = local;
+            if (placement == NodePlacement::kRemote) {
+                std::vector<int> nodes = details::GetNumaNodeList();
+                if (nodes.size() < 2) {
+                    std::cerr << "[Warning] Single NUMA node - remote arena is placed on local node" << std::endl;
+                } else {
+                    auto position = std::find(nodes.begin(), nodes.end(), local);
+                    node = position == nodes.end() || position + 1 == nodes.end() ? nodes.front() : *(position + 1);
+                }
+            }
+            if (details::BindToNumaNode(data_, capacity_, node)) {
+                node_ = node;
+            }
+        }
+
+        // Prefault every page
+        for (std::size_t offset = 0; offset < capacity_; offset += small_page) {
+            data_[offset] = std::byte{0};
+        }
+        used_ = 0;
+        return true;
+    }
+
+} // namespace benchmarking
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "tsc_calibration.h"
+#include "tsc_clock.h"
+#include "tsc_cpu.h"
+#include "tsc_statistics.h"
+#include "utils/types.h"
+
+namespace benchmarking {
+
+    /// Overhead and jitter of back-to-back StartTime()/EndTime() of one TSCClock specialization
+    class BarrierCost {
+    public:
+        /// Barrier measured
+        Barrier barrier_{Barrier::kOneCpuId};
+
+        /// Fence actually executed ("cpuid", "lfence", ...; for kAuto - fence selected for host)
+        std::string fence_{};
+
+        /// Distribution of empty StartTime()/EndTime() pairs in TSC ticks
+        Distribution distribution_{};
+
+        /// p99 minus minimum in TSC ticks (spread added to every sample)
+        TimePoint jitter_{0};
+
+        /// Average wall cost of StartTime() + EndTime() call pair in TSC ticks, including fences
+        /// outside timed interval (what barrier costs run time, not samples)
+        double call_time_{0.0};
+    };
+
+    namespace details {
+        template<Barrier BarrierType>
+        BarrierCost MeasureBarrierCost(std::size_t samples_number) {
+            TSCClock<BarrierType> clock{};
+            std::vector<TimePoint> samples(std::max<std::size_t>(samples_number, 1));
+            const TimePoint begin = Rdtsc();
+            for (TimePoint& sample : samples) {
+                const TimePoint start = clock.StartTime();
+                const TimePoint end = clock.EndTime();
+                sample = end - start;
+            }
+            const TimePoint finish = Rdtsc();
+            BarrierCost cost{};
+            cost.barrier_ = BarrierType;
+            if constexpr (BarrierType == Barrier::kAuto) {
+                cost.fence_ = ToString(clock.SelectedFence());
+            } else {
+                cost.fence_ = ToString(BarrierType);
+            }
+            cost.distribution_ = ComputeDistribution(samples);
+            cost.jitter_ = cost.distribution_.p99_ - cost.distribution_.min_;
+            cost.call_time_ = static_cast<double>(finish - begin) / static_cast<double>(samples.size());
+            return cost;
+        }
+    } // namespace details
+
+    /**
+     * @brief Measure overhead and jitter of every barrier (call on pinned thread)
+     * @param samples_number Empty StartTime()/EndTime() pairs per barrier
+     * @return One entry per Barrier (kRdtscp is skipped if RDTSCP is not supported)
+     */
+    inline std::vector<BarrierCost> MeasureBarrierCosts(std::size_t samples_number = 10000) {
+        std::vector<BarrierCost> costs;
+        costs.push_back(details::MeasureBarrierCost<Barrier::kOneCpuId>(samples_number));
+        costs.push_back(details::MeasureBarrierCost<Barrier::kLFence>(samples_number));
+        costs.push_back(details::MeasureBarrierCost<Barrier::kMFence>(samples_number));
+        if (details::CpuInfo::Instance().IsRdtscpEnabled()) {
+            costs.push_back(details::MeasureBarrierCost<Barrier::kRdtscp>(samples_number));
+        }
+        costs.push_back(details::MeasureBarrierCost<Barrier::kTwoCpuId>(samples_number));
+        costs.push_back(details::MeasureBarrierCost<Barrier::kAuto>(samples_number));
+        return costs;
+    }
+
+    /**
+     * @brief Print barrier cost table
+     * @param out Output stream
+     * @param costs Costs from MeasureBarrierCosts()
+     * @param calibration Calibration for nanosecond column (ticks only if uncalibrated)
+     */
+    inline void PrintBarrierCosts(std::ostream& out, const std::vector<BarrierCost>& costs,
+                                  const TSCCalibration& calibration) {
+        out << std::left << std::setw(18) << "Barrier" << std::right << std::setw(10) << "Min" << std::setw(10)
+            << "Median" << std::setw(10) << "p99" << std::setw(10) << "Jitter" << std::setw(10) << "Call"
+            << std::setw(12) << "Median ns" << '\n';
+        for (const BarrierCost& cost : costs) {
+            std::string name = ToString(cost.barrier_);
+            if (cost.barrier_ == Barrier::kAuto) {
+                name += " (" + cost.fence_ + ")";
+            }
+            out << std::left << std::setw(18) << name << std::right << std::setw(10) << cost.distribution_.min_
+                << std::setw(10) << cost.distribution_.median_ << std::setw(10) << cost.distribution_.p99_
+                << std::setw(10) << cost.jitter_ << std::setw(10) << std::fixed << std::setprecision(0)
+                << cost.call_time_ << std::defaultfloat << std::setprecision(6) << std::setw(12);
+            if (calibration.IsCalibrated()) {
+                out << calibration.ToNanos(cost.distribution_.median_).count();
+            } else {
+                out << '-';
+            }
+            out << '\n';
+        }
+        const details::CpuInfo& info = details::CpuInfo::Instance();
+        if (info.IsHypervisorPresent()) {
+            out << "Hypervisor detected - CPUID barriers include VM exit cost\n";
+        }
+    }
+
+} // namespace benchmarking
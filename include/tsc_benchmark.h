@@ -6,10 +6,27 @@
  * instructions for measuring small code sections with nanosecond accuracy.
  * 
  * Features:
- * - Nanosecond precision using RDTSC/RDTSCP instructions
- * - Configurable memory barriers for instruction ordering
- * - Optional CPU migration detection
+ * - Cycle precision using RDTSC/RDTSCP instructions
+ * - TSC frequency calibration with nanosecond reporting
+ * - Configurable memory barriers for instruction ordering, host-selected kAuto and cost table (tsc_barrier.h)
+ * - Optional CPU migration detection with bounded retries and discard rate
+ * - Compile-time StaticSettings for allocation-free RunStatic() loop
+ * - Optional per-sample recording with full latency distribution
+ * - Outlier pipeline (Tukey, MAD, bimodality, interrupt gaps) over recorded samples (tsc_outliers.h)
+ * - Warm, cold (flush/thrash) and TLB-cold cache state per sample
+ * - Huge-page backed, NUMA-bound arena for sample buffers and fixtures
+ * - Adaptive sample count driven by confidence interval of median/p99
+ * - Multi-threaded scalability harness with pinned workers
+ * - Optional hardware performance counters (perf_event + RDPMC) per sample
  * - Automatic overhead calculation and subtraction
+ * - Pre-flight environment checks and per-run noise score (tsc_environment.h)
+ * - Hybrid P-core/E-core detection and core class runs (tsc_hybrid.h)
+ * - Loaded latency under pinned aggressor threads (tsc_loaded.h)
+ * - Benchmark registry and suite runner (tsc_registry.h)
+ * - Always-on production probes with per-thread histograms (tsc_probe.h)
+ * - Compact binary sample files with mmap writer/reader (tsc_sample_file.h)
+ * - SPSC per-event trace ring with memory-mapped drainer (tsc_trace.h)
+ * - Coroutine resume latency through user executors (tsc_coroutine.h)
  * - Cross-platform support (Linux/macOS)
  * 
  * @author TSC Benchmark Library
@@ -23,8 +40,13 @@
 #include <cassert>
 #include <algorithm>
 #include <limits>
+#include <optional>
 #include <utility>
+#include <atomic>
 #include <iostream>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 // Linux system includes
 #include <unistd.h>
@@ -33,18 +55,75 @@
 #include <sched.h>
 
 // Project includes
+#include "tsc_arena.h"
+#include "tsc_barrier.h"
+#include "tsc_cache.h"
+#include "tsc_calibration.h"
 #include "tsc_clock.h"
+#include "tsc_environment.h"
+#include "tsc_hybrid.h"
+#include "tsc_outliers.h"
+#include "tsc_perf.h"
+#include "tsc_statistics.h"
 #include "utils/compiler.h"
 #include "utils/types.h"
 #include "utils/affinity.h"
+#include "utils/spin_barrier.h"
 
 namespace benchmarking {
 
     namespace details {
         /// Empty lambda for overhead measurement
         inline constexpr auto kEmptyCode = []() {};
+
+        /// Invoke code once per index, unrolled at compile time
+        template<typename Code, std::size_t... Indices>
+        FORCE_INLINE void InvokeUnrolled(Code& code, std::index_sequence<Indices...>) {
+            ((static_cast<void>(Indices), InvokeAndSink(code)), ...);
+        }
     } // namespace details
 
+    /// Policy of TSC overhead correction applied to every sample
+    enum class OverheadCorrection {
+        kNone,              ///< Report raw samples (overhead included)
+        kSubtractMin,       ///< Subtract minimal latency of empty code
+        kSubtractMedian     ///< Subtract median latency of empty code
+    };
+
+    /// Method used by Initialize() to measure minimal TSC/clock overhead
+    enum class OverheadCalibration {
+        kFixed,             ///< Minimum over fixed number of cycles
+        kStabilized         ///< Sample until running minimum stops improving
+    };
+
+    /**
+     * @brief Compile-time configuration of TSCBenchmarking::RunStatic()
+     *
+     * Sample count, warmup, overhead policy and retry limit are constants, so the measurement loop
+     * of RunStatic() has no run-time settings branches (no cache state, fixture hooks or counters).
+     *
+     * @tparam CyclesNumber Number of accepted samples
+     * @tparam WarmupCycles Invocations before measurement
+     * @tparam Correction Overhead subtracted from every sample
+     * @tparam RecordSamples Record every sample into preallocated buffer and compute distributions
+     * @tparam MaxMigrationRetries CPU migrations since last accepted sample after which run stops early
+     * @tparam MaxDiscardRetries Discards of any kind since last accepted sample after which run stops early
+     */
+    template<std::size_t CyclesNumber, std::size_t WarmupCycles = 0,
+             OverheadCorrection Correction = OverheadCorrection::kSubtractMin, bool RecordSamples = true,
+             std::size_t MaxMigrationRetries = 1000, std::size_t MaxDiscardRetries = 100000>
+    class StaticSettings {
+        static_assert(CyclesNumber > 0, "At least one sample must be taken");
+
+    public:
+        static constexpr std::size_t kCyclesNumber = CyclesNumber;
+        static constexpr std::size_t kWarmupCycles = WarmupCycles;
+        static constexpr OverheadCorrection kOverheadCorrection = Correction;
+        static constexpr bool kRecordSamples = RecordSamples;
+        static constexpr std::size_t kMaxMigrationRetries = MaxMigrationRetries;
+        static constexpr std::size_t kMaxDiscardRetries = MaxDiscardRetries;
+    };
+
     /**
      * @brief High-precision TSC-based benchmark class
      * 
@@ -53,6 +132,7 @@ namespace benchmarking {
      * 
      * @tparam CheckCpuMigration Enable CPU migration detection between measurements
      * @tparam BarrierType Type of memory barrier to use for instruction ordering
+     * @tparam Clock Timestamp source (TSCClock<BarrierType>, VdsoClock for VMs with unreliable TSC)
      * 
      * Example usage:
      * @code
@@ -65,17 +145,66 @@ namespace benchmarking {
      * auto result = benchmark.Run([]() { return; }, settings);
      * @endcode
      */
-    template<bool CheckCpuMigration = true, Barrier BarrierType = Barrier::kOneCpuId>
+    template<bool CheckCpuMigration = true, Barrier BarrierType = Barrier::kOneCpuId,
+             typename Clock = TSCClock<BarrierType>>
     class TSCBenchmarking {
+        static_assert(BenchmarkClock<Clock>, "Clock must provide StartTime()/EndTime() returning TimePoint");
+
     public:
         class Result;
         class Settings;
+        class ThreadResult;
+        class ParallelResult;
+        class ThroughputResult;
+
+        /// Barrier used by clock
+        static constexpr Barrier kBarrier = BarrierType;
+
+        /// True if Clock ticks are nanoseconds (VdsoClock) instead of TSC ticks
+        static constexpr bool kNanosecondClock = kIsNanosecondClock<Clock>;
+
+        /// True if samples taken across CPU migration are discarded
+        static constexpr bool kCheckCpuMigration = CheckCpuMigration;
 
         /// Constructor - validates TSC support
         TSCBenchmarking();
 
-        /// Initialize benchmark system (configure scheduling, calculate overhead)
-        void Initialize();
+        /**
+         * @brief Initialize benchmark system (configure scheduling, calculate overhead, calibrate TSC)
+         * @param settings Settings of upcoming runs - used to preallocate sample buffer
+         *                 before pages are locked when Settings::record_samples_ is set
+         */
+        void Initialize(const Settings& settings = Settings{});
+
+        /**
+         * @brief Re-measure TSC/clock overheads pinned on CPU core
+         *
+         * Initialize() measures overheads on whatever core it runs on, while fence cost differs
+         * between core types - call before runs on another core class (RunOnCoreClass() does).
+         *
+         * @param cpu CPU core (calling thread stays pinned to it)
+         * @param settings Settings::overhead_calibration_ selects fixed or stabilized measurement
+         * @return Minimal TSC overhead, or current one if thread could not be pinned
+         */
+        TimePoint MeasureOverheadOn(int cpu, const Settings& settings = Settings{});
+
+        /**
+         * @brief Arena created by Initialize() for sample buffer and Settings::arena_bytes_ of fixture data
+         *
+         * Arena is placed on NUMA node selected by Settings::arena_placement_ relative to Settings::cpu_
+         * and backed by huge pages if available. Allocate fixtures before the first run.
+         */
+        [[nodiscard]] Arena& GetArena() noexcept { return arena_; }
+
+        /// Conversion of Clock ticks (Result times) to nanoseconds performed by Initialize()
+        [[nodiscard]] const TSCCalibration& GetCalibration() const noexcept { return calibration_; }
+
+        /// TSC calibration of Rdtsc()-based values (noise gaps, throughput streams) - same as
+        /// GetCalibration() unless Clock ticks are nanoseconds
+        [[nodiscard]] const TSCCalibration& GetTscCalibration() const noexcept { return tsc_calibration_; }
+
+        /// Pre-flight check of benchmark CPU made by Initialize()
+        [[nodiscard]] const EnvironmentReport& GetEnvironment() const noexcept { return environment_; }
 
         /**
          * @brief Minimal overhead measurement for time-critical applications
@@ -88,6 +217,10 @@ namespace benchmarking {
 
         /**
          * @brief Full benchmark with statistics and overhead correction
+         *
+         * Return value of code (if any) is sunk with DoNotOptimize(), so returning result is enough
+         * to keep computation alive without volatile stores.
+         *
          * @tparam Code Callable type for code to measure  
          * @param code Code to benchmark
          * @param settings Benchmark configuration
@@ -96,6 +229,148 @@ namespace benchmarking {
         template<typename Code>
         Result Run(Code&& code, Settings settings);
 
+        /**
+         * @brief Batched benchmark for code cheaper than TSC overhead
+         *
+         * Code is invoked BatchSize times (unrolled at compile time) between a single pair
+         * of timestamps, so fence cost and serialization noise are amortized over the batch.
+         *
+         * @tparam BatchSize Number of invocations per sample
+         * @tparam Code Callable type for code to measure
+         * @param code Code to benchmark
+         * @param settings Benchmark configuration
+         * @return Benchmark result of whole batches with per-op cost in Result::per_op_time_
+         */
+        template<std::size_t BatchSize, typename Code>
+        Result RunBatched(Code&& code, Settings settings);
+
+        /**
+         * @brief Full benchmark with hardware performance counters read around every sample
+         *
+         * Counters are read before StartTime() and after EndTime(), so the fenced window is unchanged.
+         * Counts of empty code are subtracted as baseline, as with TSC overhead.
+         *
+         * @param code Code to benchmark
+         * @param settings Benchmark configuration
+         * @param counters Counters opened on calling thread (PerfCounters::Open())
+         * @return Benchmark result with counter values in Result::counters_
+         */
+        template<typename Code>
+        Result Run(Code&& code, Settings settings, PerfCounters& counters);
+
+        /// Batched benchmark with hardware performance counters (per-call counts are divided by BatchSize)
+        template<std::size_t BatchSize, typename Code>
+        Result RunBatched(Code&& code, Settings settings, PerfCounters& counters);
+
+        /**
+         * @brief Full benchmark of stateful code with per-sample fixture hooks
+         *
+         * Every sample runs setup(), then code under measurement, then teardown(); only code runs
+         * between StartTime() and EndTime(). Cache state preparation runs after setup(), so cold
+         * policies see data setup() touched evicted. If setup() returns a value, it is passed to
+         * code (and to teardown if it accepts it) by reference.
+         *
+         * @code
+         * auto result = benchmark.Run([&queue]() { queue.push(item); },
+         *                             [&queue]() { queue.pop(); },
+         *                             []() {}, settings);
+         * @endcode
+         *
+         * @param setup Per-sample preparation (returns void or input value)
+         * @param code Code to benchmark (takes input value if setup returns one)
+         * @param teardown Per-sample cleanup (may take input value)
+         * @param settings Benchmark configuration
+         * @return Benchmark result with timing and overhead information
+         */
+        template<typename Setup, typename Code, typename Teardown>
+        Result Run(Setup&& setup, Code&& code, Teardown&& teardown, Settings settings);
+
+        /**
+         * @brief Benchmark that samples until latency estimates converge
+         *
+         * Samples are taken in blocks of Settings::adaptive_block_size_ until confidence intervals
+         * of median and p99 are narrower than Settings::target_relative_ci_ (see ConvergenceRule),
+         * Settings::max_time_budget_ is spent or Settings::cycles_number_ samples are taken.
+         * Samples are always recorded; pass the same settings with Settings::record_samples_ set
+         * to Initialize() to preallocate buffer.
+         *
+         * @param code Code to benchmark
+         * @param settings Benchmark configuration (cycles_number_ is upper bound of samples)
+         * @return Benchmark result with number of samples used in Result::samples_number_
+         */
+        template<typename Code>
+        Result RunAdaptive(Code&& code, Settings settings);
+
+        /**
+         * @brief Scalability sweep with one pinned worker per listed CPU
+         *
+         * For every n in 1..cpus.size() workers pinned to the first n CPUs meet on a spin barrier,
+         * start together at a shared TSC deadline and each take Settings::cycles_number_ samples.
+         * Code must be safe to call concurrently; it may accept worker index (std::size_t).
+         * Settings::cpu_ is ignored.
+         *
+         * @tparam Code Callable type for code to measure
+         * @param code Code to benchmark
+         * @param cpus CPU cores of workers in order they are added to sweep
+         * @param settings Benchmark configuration
+         * @return Scaling curve - one entry per number of threads
+         */
+        template<typename Code>
+        std::vector<ParallelResult> RunParallel(Code&& code, const std::vector<int>& cpus, Settings settings);
+
+        /// Scalability sweep over all online CPU cores (0..GetCpuCoreCount()-1)
+        template<typename Code>
+        std::vector<ParallelResult> RunParallel(Code&& code, Settings settings);
+
+        /**
+         * @brief Fenced latency and unfenced reciprocal throughput of the same code
+         *
+         * Latency is the per-invocation median of Run() bracketed by BarrierType fences. Throughput
+         * streams StreamLength back-to-back invocations between two plain Rdtsc() reads, so
+         * independent invocations overlap in the out-of-order core as in production loops; the
+         * stream is repeated Settings::cycles_number_ times and its median is divided by StreamLength.
+         * Latency close to throughput means invocations serialize (latency bound), latency well
+         * above throughput means they overlap (throughput bound). Both sides are overhead-corrected:
+         * OverheadCorrection::kNone is replaced with kSubtractMin for the latency run, because
+         * stream times always have Rdtsc() pair cost subtracted.
+         *
+         * @tparam StreamLength Invocations per unfenced stream (multiple of 8 or less than 8)
+         * @param code Code to benchmark (invocations must be independent to overlap)
+         * @param settings Benchmark configuration of both measurements
+         * @return Latency/throughput pair
+         */
+        template<std::size_t StreamLength = 1024, typename Code>
+        ThroughputResult RunThroughput(Code&& code, Settings settings);
+
+        /**
+         * @brief Run-time Settings equivalent of StaticSettings (pass to Initialize() to preallocate buffer)
+         * @tparam Config StaticSettings<...>
+         * @param cpu CPU core to pin thread to
+         */
+        template<typename Config>
+        static Settings MakeSettings(int cpu = 0);
+
+        /**
+         * @brief Benchmark with compile-time configuration for kernels close to the noise floor
+         *
+         * Measurement loop only times code, accepts or discards the sample and stores it into
+         * the buffer preallocated by Initialize(MakeSettings<Config>()); it neither allocates nor
+         * branches on run-time settings. Result is the same as Run() with MakeSettings<Config>(cpu).
+         *
+         * @code
+         * using Config = benchmarking::StaticSettings<10000, 1000>;
+         * benchmark.Initialize(Benchmark::MakeSettings<Config>());
+         * auto result = benchmark.RunStatic<Config>([&counter]() { ++counter; });
+         * @endcode
+         *
+         * @tparam Config StaticSettings<...>
+         * @param code Code to benchmark
+         * @param cpu CPU core to pin thread to
+         * @return Benchmark result with timing and overhead information
+         */
+        template<typename Config, typename Code>
+        Result RunStatic(Code&& code, int cpu = 0);
+
         ~TSCBenchmarking() = default;
 
         /**
@@ -111,6 +386,63 @@ namespace benchmarking {
             
             /// Number of warmup cycles before measurement  
             std::size_t cache_warmup_cycles_number_{0};
+
+            /// Record every accepted sample and compute latency distribution
+            bool record_samples_{false};
+
+            /// Overhead subtracted from every sample (corrected samples are clamped at 0)
+            OverheadCorrection overhead_correction_{OverheadCorrection::kNone};
+
+            /// Overhead measurement method used by Initialize()
+            OverheadCalibration overhead_calibration_{OverheadCalibration::kFixed};
+
+            /// Target relative width of median/p99 confidence intervals of RunAdaptive()
+            double target_relative_ci_{0.01};
+
+            /// Time limit of RunAdaptive() sampling
+            std::chrono::milliseconds max_time_budget_{1000};
+
+            /// Number of samples between convergence checks of RunAdaptive()
+            std::size_t adaptive_block_size_{1000};
+
+            /// Cache state prepared before every sample of Run()/RunBatched()/RunAdaptive() (outside timed region)
+            CacheState cache_state_{CacheState::kWarm};
+
+            /// Regions flushed by CacheState::kColdFlush
+            std::vector<FlushRegion> flush_regions_{};
+
+            /// Size of CacheState::kColdThrash buffer in bytes (0 - 1.5x LLC size)
+            std::size_t thrash_bytes_{0};
+
+            /// Arena capacity for fixture data on top of sample buffer (see GetArena())
+            std::size_t arena_bytes_{0};
+
+            /// Page size policy of arena
+            ArenaPages arena_pages_{ArenaPages::kAuto};
+
+            /// NUMA node of arena relative to cpu_ (kRemote measures cross-node access on purpose)
+            NodePlacement arena_placement_{NodePlacement::kLocal};
+
+            /// Rdtsc() gap probe time per run, split before and after sampling (0 - disabled)
+            std::chrono::microseconds noise_probe_time_{1000};
+
+            /// Jump between consecutive Rdtsc() reads counted as interrupt/SMI gap
+            std::chrono::nanoseconds noise_gap_threshold_{1000};
+
+            /// Noise score above which result is flagged as noisy
+            double max_noise_score_{0.01};
+
+            /// CPU migrations since last accepted sample after which run stops early instead of retrying
+            /// forever
+            std::size_t max_migration_retries_{1000};
+
+            /// Discards of any kind (migration, non-monotonic or at/below TSC overhead) since last accepted
+            /// sample after which run stops early - larger than max_migration_retries_, as near-empty code
+            /// is often discarded for a while when fence cost drops below overhead measured by Initialize()
+            std::size_t max_discard_retries_{100000};
+
+            /// Outlier pipeline applied to recorded samples (Result::outliers_, convergence of RunAdaptive())
+            OutlierSettings outliers_{};
         };
 
         /**
@@ -119,19 +451,176 @@ namespace benchmarking {
         class Result {
         public:
             using Nanos = std::chrono::nanoseconds;
+            using FractionalNanos = std::chrono::duration<double, std::nano>;
             
-            /// Average execution time in nanoseconds
-            TimePoint time_;
+            /// Average execution time in TSC ticks
+            TimePoint time_{0};
             
-            /// Measured TSC overhead in nanoseconds
-            TimePoint overhead_;
+            /// Measured TSC overhead in TSC ticks
+            TimePoint overhead_{0};
+
+            /// Average execution time converted with TSC calibration
+            Nanos time_ns_{0};
+
+            /// Measured TSC overhead converted with TSC calibration
+            Nanos overhead_ns_{0};
+
+            /// Overhead correction policy applied
+            OverheadCorrection overhead_correction_{OverheadCorrection::kNone};
+
+            /// Overhead subtracted from every sample in TSC ticks
+            TimePoint applied_overhead_{0};
+
+            /// Average overhead-corrected execution time in TSC ticks
+            TimePoint corrected_time_{0};
+
+            /// Average overhead-corrected execution time converted with TSC calibration
+            Nanos corrected_time_ns_{0};
+
+            /// Measured clock_gettime() cost (excluding TSC overhead) in TSC ticks
+            TimePoint clock_overhead_{0};
+
+            /// Raw latency distribution (filled if Settings::record_samples_ is set)
+            Distribution distribution_{};
+
+            /// Overhead-corrected latency distribution (filled if Settings::record_samples_ is set)
+            Distribution corrected_distribution_{};
+
+            /// Raw accepted samples in measurement order (filled if Settings::record_samples_ is set)
+            std::vector<TimePoint> samples_{};
+
+            /// Number of code invocations per sample
+            std::size_t batch_size_{1};
+
+            /// Average overhead-corrected time of single invocation in TSC ticks
+            double per_op_time_{0.0};
+
+            /// Average overhead-corrected time of single invocation converted with TSC calibration
+            FractionalNanos per_op_time_ns_{0.0};
+
+            /// TSC overhead amortized over batch in TSC ticks
+            double amortized_overhead_{0.0};
+
+            /// Hardware counter values (filled if run with PerfCounters)
+            CounterResult counters_{};
+
+            /// Number of accepted samples averaged into result
+            std::size_t samples_number_{0};
+
+            /// True if RunAdaptive() reached target confidence interval before running out of budget
+            bool converged_{false};
+
+            /// Confidence interval of raw median (filled by RunAdaptive())
+            QuantileInterval median_ci_{};
+
+            /// Confidence interval of raw 99th percentile (filled by RunAdaptive())
+            QuantileInterval p99_ci_{};
+
+            /// Cache state every sample started in
+            CacheState cache_state_{CacheState::kWarm};
+
+            /// Rdtsc() gaps observed on pinned core around sampling
+            GapStatistics noise_{};
+
+            /// Fraction of probe time lost to interrupts/SMIs/preemption (0 - quiet core)
+            double noise_score_{0.0};
+
+            /// True if noise_score_ exceeds Settings::max_noise_score_
+            bool noisy_{false};
+
+            /// Core type of Settings::cpu_ (kUnknown on non-hybrid CPUs)
+            CoreType core_type_{CoreType::kUnknown};
+
+            /// Attempts discarded because code migrated between CPU cores (CheckCpuMigration only)
+            std::size_t migrations_number_{0};
+
+            /// Attempts discarded for any reason (migration, non-monotonic or below TSC overhead)
+            std::size_t discarded_number_{0};
+
+            /// Fraction of attempts discarded: discarded / (accepted + discarded)
+            double discard_rate_{0.0};
+
+            /// True if run stopped early after more than Settings::max_migration_retries_ migrations or
+            /// Settings::max_discard_retries_ discards in a row
+            bool aborted_{false};
+
+            /// Outlier classification of corrected samples (filled if Settings::outliers_ is enabled
+            /// and Settings::record_samples_ is set)
+            OutlierReport outliers_{};
+        };
+
+        /**
+         * @brief Per-worker measurement of parallel run
+         */
+        class ThreadResult {
+        public:
+            /// CPU core worker was pinned to
+            int cpu_{0};
+
+            /// Latency distribution of worker samples (corrected by Settings::overhead_correction_)
+            Distribution distribution_{};
+
+            /// Worker run time from start gate to last sample in TSC ticks
+            TimePoint elapsed_{0};
+
+            /// Completed invocations per second
+            double throughput_{0.0};
+        };
+
+        /**
+         * @brief Parallel run with fixed number of threads (one point of scaling curve)
+         */
+        class ParallelResult {
+        public:
+            /// Number of concurrently running workers
+            std::size_t threads_number_{0};
+
+            /// Per-worker results in order of CPU list
+            std::vector<ThreadResult> threads_{};
+
+            /// Total invocations of all workers per second of wall time
+            double aggregate_throughput_{0.0};
+
+            /// Aggregate throughput relative to ideal linear scaling of single thread
+            double scaling_efficiency_{0.0};
+        };
+
+        /**
+         * @brief Fenced latency paired with unfenced reciprocal throughput (see RunThroughput())
+         */
+        class ThroughputResult {
+        public:
+            using FractionalNanos = std::chrono::duration<double, std::nano>;
+
+            /// Fenced measurement of single invocations
+            Result latency_{};
+
+            /// Distribution of unfenced stream times in TSC ticks (Rdtsc() pair cost subtracted)
+            Distribution streams_{};
+
+            /// Invocations per unfenced stream
+            std::size_t stream_length_{0};
+
+            /// Fenced latency per invocation in TSC ticks (corrected median)
+            double latency_time_{0.0};
+            FractionalNanos latency_time_ns_{0.0};
+
+            /// Reciprocal throughput in TSC ticks per invocation (median stream / stream_length_)
+            double throughput_time_{0.0};
+            FractionalNanos throughput_time_ns_{0.0};
+
+            /// latency_time_ / throughput_time_ (about 1 - latency bound, higher - invocations overlap)
+            double overlap_{0.0};
         };
 
     private:
+        using SampleBuffer = std::vector<TimePoint, ArenaAllocator<TimePoint>>;
+
         // Default configuration constants
         static constexpr std::size_t kDefaultCyclesNumber = 100;
         static constexpr std::size_t kDefaultStabilizedThreshold = kDefaultCyclesNumber * 10 / 100;
         static constexpr std::size_t kDefaultRunsNumber = 100;
+        static constexpr std::int64_t kStartGateDelayNs = 100'000;
 
         /// Dummy clock operation for overhead measurement
         static constexpr auto kGetTime = []() {
@@ -140,6 +629,9 @@ namespace benchmarking {
         };
         
         // Private measurement methods
+        /// Measure tsc_overhead_, clock_overhead_ and tsc_median_overhead_ on current core
+        void CalibrateOverhead(const Settings& settings);
+
         std::pair<TimePoint, TimePoint> MeasureOverhead(std::size_t cycles_number = kDefaultCyclesNumber);
         
         std::pair<TimePoint, TimePoint> MeasureStabilizedOverhead(std::size_t cycles_number = kDefaultCyclesNumber,
@@ -148,6 +640,9 @@ namespace benchmarking {
         template<typename Code>
         FORCE_INLINE TimePoint MeasureMinLatency(std::size_t cycles_number, Code&& code);
 
+        template<typename Code>
+        FORCE_INLINE TimePoint MeasureMedianLatency(std::size_t cycles_number, Code&& code);
+
         template<typename Code>
         FORCE_INLINE TimePoint MeasureStabilizedMinLatency(std::size_t cycles_number,
                                                            std::size_t stabilized_threshold,
@@ -156,26 +651,130 @@ namespace benchmarking {
         template<typename Code>
         FORCE_INLINE bool Measure(TimePoint& start, TimePoint& end, Code&& code);
 
+        /// Sampling progress of single run shared by BeginRun(), SampleBlock() and FinishRun()
+        class RunState {
+        public:
+            Settings settings_{};
+            std::size_t batch_size_{1};
+            PerfCounters* counters_{nullptr};
+            std::size_t events_number_{0};
+            TimePoint applied_overhead_{0};
+            std::size_t samples_number_{0};
+            std::uint64_t summary_time_{0};
+            std::uint64_t summary_corrected_time_{0};
+            std::uint64_t counter_sums_[PerfCounters::kMaxEvents]{};
+            std::uint64_t counter_baseline_[PerfCounters::kMaxEvents]{};
+            GapStatistics noise_{};
+            std::size_t migrations_number_{0};
+            std::size_t discarded_number_{0};
+            bool aborted_{false};
+            bool discard_limit_{false};          ///< Abort was caused by max_discard_retries_, not migrations
+        };
+
+        template<typename Code, typename Setup, typename Teardown>
+        Result RunImpl(Code& code, const Settings& settings, std::size_t batch_size, PerfCounters* counters,
+                       Setup& setup, Teardown& teardown);
+
+        /// Pin thread, warm up cache and prepare buffers and counter baseline
+        template<typename Code, typename Setup, typename Teardown>
+        RunState BeginRun(Code& code, const Settings& settings, std::size_t batch_size, PerfCounters* counters,
+                          Setup& setup, Teardown& teardown);
+
+        /// Append count accepted samples to run (setup/teardown run around every sample outside timed region)
+        template<typename Code, typename Setup, typename Teardown>
+        void SampleBlock(Code& code, RunState& state, std::size_t count, Setup& setup, Teardown& teardown);
+
+        /// Build result from samples taken so far
+        Result FinishRun(const RunState& state);
+
+        /// Subtract overhead from sample (clamped at 0)
+        static FORCE_INLINE TimePoint Correct(TimePoint time, TimePoint overhead) noexcept {
+            return time > overhead ? time - overhead : 0;
+        }
+
+        void MeasureCounterBaseline(PerfCounters& counters, std::uint64_t* baseline);
+
+        template<typename Code>
+        ParallelResult RunParallelStep(Code& code, const std::vector<int>& cpus, const Settings& settings);
+
+        [[nodiscard]] TimePoint GetAppliedOverhead(OverheadCorrection correction) const noexcept;
+
+        /// Spin half of noise probe time on pinned core
+        GapStatistics ProbeNoise(const Settings& settings) const noexcept;
+
+        /// Settings::noise_gap_threshold_ in Clock ticks (samples' unit)
+        [[nodiscard]] TimePoint GetGapTicks(const Settings& settings) const noexcept;
+
     private:
-        TSCClock<BarrierType> clock_{};         ///< TSC clock instance
+        Clock clock_{};                         ///< Clock instance (TSCClock<BarrierType> by default)
         TimePoint tsc_overhead_{0};             ///< Measured TSC overhead
+        TimePoint tsc_median_overhead_{0};      ///< Median TSC overhead
         TimePoint clock_overhead_{0};           ///< Measured clock overhead
+        TSCCalibration calibration_{};          ///< Clock ticks to nanoseconds conversion
+        TSCCalibration tsc_calibration_{};      ///< TSC calibration of internal Rdtsc() deadlines and probes
+        Arena arena_{};                         ///< Placement-controlled memory (outlives samples_)
+        SampleBuffer samples_{ArenaAllocator<TimePoint>{&arena_}};  ///< Preallocated per-sample buffer
+        std::vector<std::uint64_t> counter_samples_{};  ///< Per-sample counter buffer
+        details::CacheController cache_controller_{};   ///< Cache state preparation between samples
+        EnvironmentReport environment_{};       ///< Pre-flight check of Initialize()
     };
 
 
     // Implementation
-    template<bool CheckCpuMigration, Barrier BarrierType>
-    TSCBenchmarking<CheckCpuMigration, BarrierType>::TSCBenchmarking() {
-        details::CpuInfo cpu_info{};
+    template<bool CheckCpuMigration, Barrier BarrierType, typename Clock>
+    TimePoint TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::GetGapTicks(const Settings& settings) const noexcept {
+        return static_cast<TimePoint>(calibration_.TicksPerNanosecond() * static_cast<double>(settings.noise_gap_threshold_.count()));
+    }
+
+    template<bool CheckCpuMigration, Barrier BarrierType, typename Clock>
+    GapStatistics TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::ProbeNoise(const Settings& settings) const noexcept {
+        if (settings.noise_probe_time_.count() <= 0) {
+            return {};
+        }
+        const double ticks_per_ns = tsc_calibration_.TicksPerNanosecond();
+        const auto probe_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(settings.noise_probe_time_).count() / 2;
+        return details::DetectGaps(static_cast<TimePoint>(ticks_per_ns * static_cast<double>(probe_ns)),
+                                   static_cast<TimePoint>(ticks_per_ns * static_cast<double>(settings.noise_gap_threshold_.count())));
+    }
+
+    template<bool CheckCpuMigration, Barrier BarrierType, typename Clock>
+    TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::TSCBenchmarking() {
+        const details::CpuInfo& cpu_info = details::CpuInfo::Instance();
+        // Checked at run time as well - assert() is compiled out of release builds
         assert(cpu_info.IsTscEnabled());
         assert(BarrierType != Barrier::kRdtscp || cpu_info.IsRdtscpEnabled());
-        if (!cpu_info.IsInvariantTscEnabled()) {
+        if (!cpu_info.IsTscEnabled()) {
+            std::cerr << "[Warning] TSC is not supported on your system" << std::endl;
+        } else if (!cpu_info.IsInvariantTscEnabled()) {
             std::cerr << "[Warning] Invariant TSC is not supported on your system" << std::endl;
         }
+        if (!cpu_info.IsRdtscpEnabled() && (BarrierType == Barrier::kRdtscp || CheckCpuMigration)) {
+            std::cerr << "[Warning] RDTSCP is not supported on your system" << std::endl;
+        }
+        if (cpu_info.IsHypervisorPresent()) {
+            std::cout << "[Info] Running under " << (cpu_info.HypervisorVendor().empty() ? "unknown" : cpu_info.HypervisorVendor())
+                      << " hypervisor" << std::endl;
+        }
     }
 
-    template<bool CheckCpuMigration, Barrier BarrierType>
-    void TSCBenchmarking<CheckCpuMigration, BarrierType>::Initialize() {
+    template<bool CheckCpuMigration, Barrier BarrierType, typename Clock>
+    void TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::Initialize(const Settings& settings) {
+        // Sample buffer is touched here so that it is locked and resident before measurements
+        const std::size_t sample_bytes = settings.record_samples_ ? settings.cycles_number_ * sizeof(TimePoint) : 0;
+        if (sample_bytes + settings.arena_bytes_ > 0) {
+            samples_ = SampleBuffer{ArenaAllocator<TimePoint>{&arena_}};
+            if (arena_.Create(sample_bytes + settings.arena_bytes_ + kCacheLineSize, settings.cpu_,
+                              settings.arena_placement_, settings.arena_pages_)) {
+                std::cout << "[Info] Arena of " << arena_.Capacity() / 1024 << " KiB on NUMA node " << arena_.Node()
+                          << " (" << (arena_.IsHugeTlb() ? "reserved huge pages" :
+                                      arena_.PageSize() == Arena::kHugePageSize ? "transparent huge pages" : "small pages")
+                          << ")" << std::endl;
+            }
+        }
+        if (settings.record_samples_) {
+            samples_.assign(settings.cycles_number_, 0);
+        }
+
         // Linux real-time optimizations
         if (geteuid() == 0) {
             sched_param sp{};
@@ -196,24 +795,272 @@ namespace benchmarking {
         }
 
 
-        auto overheads = MeasureOverhead();
-        tsc_overhead_ = overheads.first;
-        clock_overhead_ = overheads.second;
+        CalibrateOverhead(settings);
+
+        tsc_calibration_ = TSCCalibration::Calibrate();
+        if (tsc_calibration_.IsCalibrated()) {
+            std::cout << "[Info] TSC frequency " << tsc_calibration_.Frequency() / 1e6 << " MHz ("
+                      << ToString(tsc_calibration_.Source()) << ")" << std::endl;
+        } else if (!kNanosecondClock) {
+            std::cerr << "[Warning] TSC frequency calibration failed - results are reported in ticks" << std::endl;
+        }
+        calibration_ = kNanosecondClock ? TSCCalibration::FromFrequency(1e9, CalibrationSource::kNanosecondClock)
+                                        : tsc_calibration_;
+
+        environment_ = CheckEnvironment(settings.cpu_, !kNanosecondClock);
+        if (const CoreType core_type = GetCoreType(settings.cpu_); core_type != CoreType::kUnknown) {
+            environment_.warnings_.push_back("CPU " + std::to_string(settings.cpu_) + " is " + ToString(core_type) +
+                                             " of hybrid CPU - results depend on core type (use RunOnCoreClass())");
+        }
+        environment_.Print(std::cerr);
     }
 
-    template<bool CheckCpuMigration, Barrier BarrierType>
+    template<bool CheckCpuMigration, Barrier BarrierType, typename Clock>
     template<typename Code>
-    TimePoint TSCBenchmarking<CheckCpuMigration, BarrierType>::MeasureTime(Code&& code) {
+    TimePoint TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::MeasureTime(Code&& code) {
         TimePoint start = clock_.StartTime();
-        code();
+        details::InvokeAndSink(code);
         TimePoint end = clock_.EndTime();
         return end - start;
     }
 
-    template<bool CheckCpuMigration, Barrier BarrierType>
+    template<bool CheckCpuMigration, Barrier BarrierType, typename Clock>
     template<typename Code>
-    TSCBenchmarking<CheckCpuMigration, BarrierType>::Result TSCBenchmarking<CheckCpuMigration, BarrierType>::Run(Code&& code,
+    TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::Result TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::Run(Code&& code,
                                                                            TSCBenchmarking::Settings settings) {
+        return RunImpl(code, settings, 1, nullptr, details::kEmptyCode, details::kEmptyCode);
+    }
+
+    template<bool CheckCpuMigration, Barrier BarrierType, typename Clock>
+    template<std::size_t BatchSize, typename Code>
+    TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::Result TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::RunBatched(
+            Code&& code, TSCBenchmarking::Settings settings) {
+        static_assert(BatchSize > 0, "Batch must contain at least one invocation");
+        auto batch = [&code]() FORCE_INLINE_LAMBDA {
+            details::InvokeUnrolled(code, std::make_index_sequence<BatchSize>{});
+        };
+        return RunImpl(batch, settings, BatchSize, nullptr, details::kEmptyCode, details::kEmptyCode);
+    }
+
+    template<bool CheckCpuMigration, Barrier BarrierType, typename Clock>
+    template<typename Config>
+    TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::Settings TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::MakeSettings(
+            int cpu) {
+        Settings settings{};
+        settings.cycles_number_ = Config::kCyclesNumber;
+        settings.cpu_ = cpu;
+        settings.cache_warmup_cycles_number_ = Config::kWarmupCycles;
+        settings.record_samples_ = Config::kRecordSamples;
+        settings.overhead_correction_ = Config::kOverheadCorrection;
+        settings.max_migration_retries_ = Config::kMaxMigrationRetries;
+        settings.max_discard_retries_ = Config::kMaxDiscardRetries;
+        return settings;
+    }
+
+    template<bool CheckCpuMigration, Barrier BarrierType, typename Clock>
+    template<typename Config, typename Code>
+    TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::Result TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::RunStatic(
+            Code&& code, int cpu) {
+        constexpr std::size_t kCycles = Config::kCyclesNumber;
+        constexpr std::size_t kMaxRetries = Config::kMaxMigrationRetries;
+        constexpr std::size_t kMaxDiscards = Config::kMaxDiscardRetries;
+
+        RunState state{};
+        state.settings_ = MakeSettings<Config>(cpu);
+        state.applied_overhead_ = GetAppliedOverhead(Config::kOverheadCorrection);
+        if (!details::PinThread(cpu)) {
+            std::cerr << "[Warning] Failed to pin thread to CPU " << cpu << std::endl;
+        }
+        if constexpr (Config::kRecordSamples) {
+            if (samples_.size() < kCycles) {
+                std::cerr << "[Warning] Sample buffer was not preallocated by Initialize() for "
+                          << kCycles << " cycles" << std::endl;
+                samples_.assign(kCycles, 0);
+            }
+        }
+        state.noise_ = ProbeNoise(state.settings_);
+
+        TimePoint* const samples = samples_.data();
+        const TimePoint tsc_overhead = tsc_overhead_;
+        const TimePoint applied_overhead = state.applied_overhead_;
+        std::uint64_t summary_time = 0, summary_corrected_time = 0;
+        std::size_t discarded = 0, migrations = 0, retries = 0, discards = 0;
+        TimePoint start, end;
+
+        for (std::size_t r = 0; r < Config::kWarmupCycles; ++r) {
+            start = clock_.StartTime();
+            details::InvokeAndSink(code);
+            end = clock_.EndTime();
+        }
+
+        std::size_t r = 0;
+        while (r < kCycles) {
+            bool migrated = false;
+            if constexpr (CheckCpuMigration) {
+                CpuId cpu_number0{0}, cpu_number1{1};
+                start = clock_.StartTime(cpu_number0);
+                details::InvokeAndSink(code);
+                end = clock_.EndTime(cpu_number1);
+                migrated = cpu_number0 != cpu_number1;
+            } else {
+                start = clock_.StartTime();
+                details::InvokeAndSink(code);
+                end = clock_.EndTime();
+            }
+
+            if (LIKELY(!migrated && end > start && end - start > tsc_overhead)) {
+                const TimePoint time = end - start;
+                summary_time += time;
+                if constexpr (Config::kOverheadCorrection == OverheadCorrection::kNone) {
+                    summary_corrected_time += time;
+                } else {
+                    summary_corrected_time += Correct(time, applied_overhead);
+                }
+                if constexpr (Config::kRecordSamples) {
+                    samples[r] = time;
+                }
+                ++r;
+                retries = discards = 0;
+                continue;
+            }
+            ++discarded;
+            if (migrated) {
+                ++migrations;
+                if (UNLIKELY(++retries > kMaxRetries)) {
+                    state.aborted_ = true;
+                    break;
+                }
+            }
+            if (UNLIKELY(++discards > kMaxDiscards)) {
+                state.aborted_ = state.discard_limit_ = true;
+                break;
+            }
+        }
+
+        state.samples_number_ = r;
+        state.summary_time_ = summary_time;
+        state.summary_corrected_time_ = summary_corrected_time;
+        state.discarded_number_ = discarded;
+        state.migrations_number_ = migrations;
+        return FinishRun(state);
+    }
+
+    template<bool CheckCpuMigration, Barrier BarrierType, typename Clock>
+    template<typename Code>
+    TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::Result TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::Run(
+            Code&& code, TSCBenchmarking::Settings settings, PerfCounters& counters) {
+        return RunImpl(code, settings, 1, &counters, details::kEmptyCode, details::kEmptyCode);
+    }
+
+    template<bool CheckCpuMigration, Barrier BarrierType, typename Clock>
+    template<typename Setup, typename Code, typename Teardown>
+    TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::Result TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::Run(
+            Setup&& setup, Code&& code, Teardown&& teardown, TSCBenchmarking::Settings settings) {
+        using Input = std::invoke_result_t<Setup&>;
+        static_assert(!std::is_reference_v<Input>, "Setup must return void or input value");
+        if constexpr (std::is_void_v<Input>) {
+            return RunImpl(code, settings, 1, nullptr, setup, teardown);
+        } else {
+            // Input lives outside timed region; dereference in measured code is a plain load
+            std::optional<Input> input{};
+            auto prepare = [&setup, &input]() FORCE_INLINE_LAMBDA { input.emplace(setup()); };
+            auto measured = [&code, &input]() FORCE_INLINE_LAMBDA { details::InvokeAndSink(code, *input); };
+            auto finish = [&teardown, &input]() FORCE_INLINE_LAMBDA {
+                if constexpr (std::is_invocable_v<Teardown&, Input&>) {
+                    teardown(*input);
+                } else {
+                    teardown();
+                }
+                input.reset();
+            };
+            return RunImpl(measured, settings, 1, nullptr, prepare, finish);
+        }
+    }
+
+    template<bool CheckCpuMigration, Barrier BarrierType, typename Clock>
+    template<std::size_t BatchSize, typename Code>
+    TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::Result TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::RunBatched(
+            Code&& code, TSCBenchmarking::Settings settings, PerfCounters& counters) {
+        static_assert(BatchSize > 0, "Batch must contain at least one invocation");
+        auto batch = [&code]() FORCE_INLINE_LAMBDA {
+            details::InvokeUnrolled(code, std::make_index_sequence<BatchSize>{});
+        };
+        return RunImpl(batch, settings, BatchSize, &counters, details::kEmptyCode, details::kEmptyCode);
+    }
+
+    template<bool CheckCpuMigration, Barrier BarrierType, typename Clock>
+    template<typename Code, typename Setup, typename Teardown>
+    TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::Result TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::RunImpl(
+            Code& code, const Settings& settings, std::size_t batch_size, PerfCounters* counters,
+            Setup& setup, Teardown& teardown) {
+        RunState state = BeginRun(code, settings, batch_size, counters, setup, teardown);
+        SampleBlock(code, state, settings.cycles_number_, setup, teardown);
+        return FinishRun(state);
+    }
+
+    template<bool CheckCpuMigration, Barrier BarrierType, typename Clock>
+    template<typename Code>
+    TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::Result TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::RunAdaptive(
+            Code&& code, TSCBenchmarking::Settings settings) {
+        settings.record_samples_ = true;
+        RunState state = BeginRun(code, settings, 1, nullptr, details::kEmptyCode, details::kEmptyCode);
+
+        ConvergenceRule rule{};
+        rule.target_relative_ci_ = settings.target_relative_ci_;
+        const std::size_t block_size = std::max<std::size_t>(settings.adaptive_block_size_, 1);
+        rule.min_samples_ = std::min(block_size, settings.cycles_number_);
+
+        // Scratch copy for convergence checks - touched before sampling starts
+        std::vector<TimePoint> scratch(settings.cycles_number_, 0);
+        const auto budget_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(settings.max_time_budget_).count();
+        const TimePoint budget = static_cast<TimePoint>(tsc_calibration_.TicksPerNanosecond() * static_cast<double>(budget_ns));
+        const TimePoint deadline = details::Rdtsc() + budget;
+
+        // With outlier pipeline enabled intervals are computed over kept samples, so interrupt-hit
+        // samples do not widen p99 interval of otherwise clean data
+        const TimePoint gap_ticks = GetGapTicks(settings);
+        auto inliers = [&settings, &scratch, gap_ticks](std::size_t samples_number) {
+            return settings.outliers_.enabled_
+                   ? details::KeepInliers({scratch.data(), samples_number}, settings.outliers_, gap_ticks)
+                   : samples_number;
+        };
+
+        QuantileInterval median{}, p99{};
+        bool converged = false;
+        std::size_t next_check = block_size;
+        while (state.samples_number_ < settings.cycles_number_ && !state.aborted_) {
+            SampleBlock(code, state, std::min(block_size, settings.cycles_number_ - state.samples_number_),
+                        details::kEmptyCode, details::kEmptyCode);
+            if (state.samples_number_ >= next_check) {
+                std::copy_n(samples_.begin(), state.samples_number_, scratch.begin());
+                converged = rule.IsConverged({scratch.data(), inliers(state.samples_number_)}, median, p99);
+                if (converged) {
+                    break;
+                }
+                // Geometric check spacing keeps total selection cost linear in number of samples
+                next_check = state.samples_number_ + std::max(block_size, state.samples_number_ / 4);
+            }
+            if (details::Rdtsc() >= deadline) {
+                break;
+            }
+        }
+
+        if (!converged) {
+            std::copy_n(samples_.begin(), state.samples_number_, scratch.begin());
+            rule.IsConverged({scratch.data(), inliers(state.samples_number_)}, median, p99);
+        }
+        TSCBenchmarking::Result result = FinishRun(state);
+        result.converged_ = converged;
+        result.median_ci_ = median;
+        result.p99_ci_ = p99;
+        return result;
+    }
+
+    template<bool CheckCpuMigration, Barrier BarrierType, typename Clock>
+    template<typename Code, typename Setup, typename Teardown>
+    TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::RunState TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::BeginRun(
+            Code& code, const Settings& settings, std::size_t batch_size, PerfCounters* counters,
+            Setup& setup, Teardown& teardown) {
         if (!details::PinThread(settings.cpu_)) {
             std::cerr << "[Warning] Failed to pin thread to CPU " << settings.cpu_ << std::endl;
         }
@@ -221,54 +1068,477 @@ namespace benchmarking {
         TimePoint start, end;
 
         for (std::size_t r = 0; r < settings.cache_warmup_cycles_number_; ++r) {
+            setup();
             if constexpr (CheckCpuMigration) {
                 CpuId cpu_number0{0}, cpu_number1{1};
                 start = clock_.StartTime(cpu_number0);
-                code.operator()();
+                details::InvokeAndSink(code);
                 end = clock_.EndTime(cpu_number1);
             } else {
                 start = clock_.StartTime();
-                code.operator()();
+                details::InvokeAndSink(code);
                 end = clock_.EndTime();
             }
+            teardown();
+        }
+
+        if (settings.record_samples_ && samples_.size() < settings.cycles_number_) {
+            std::cerr << "[Warning] Sample buffer was not preallocated by Initialize() for "
+                      << settings.cycles_number_ << " cycles" << std::endl;
+            samples_.assign(settings.cycles_number_, 0);
         }
 
-        std::uint64_t summary_time = 0;
-        for (std::size_t r = 0; r < settings.cycles_number_;) {
+        cache_controller_.Prepare(settings.cache_state_, settings.thrash_bytes_, settings.flush_regions_);
+
+        RunState state{};
+        state.settings_ = settings;
+        state.batch_size_ = batch_size;
+        state.applied_overhead_ = GetAppliedOverhead(settings.overhead_correction_);
+
+        if (counters != nullptr && !counters->IsOpen()) {
+            std::cerr << "[Warning] Performance counters are not open - run without counters" << std::endl;
+            counters = nullptr;
+        }
+        state.counters_ = counters;
+        state.events_number_ = counters != nullptr ? counters->Events().size() : 0;
+        if (counters != nullptr) {
+            MeasureCounterBaseline(*counters, state.counter_baseline_);
+            if (settings.record_samples_) {
+                counter_samples_.assign(settings.cycles_number_ * state.events_number_, 0);
+            }
+        }
+        state.noise_ = ProbeNoise(settings);
+        return state;
+    }
+
+    template<bool CheckCpuMigration, Barrier BarrierType, typename Clock>
+    template<typename Code, typename Setup, typename Teardown>
+    void TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::SampleBlock(Code& code, RunState& state, std::size_t count,
+                                                                      Setup& setup, Teardown& teardown) {
+        // Hot state is kept in locals so that stores to sample buffer do not force reloads
+        PerfCounters* const counters = state.counters_;
+        const std::size_t events_number = state.events_number_;
+        const bool record_samples = state.settings_.record_samples_;
+        const TimePoint applied_overhead = state.applied_overhead_;
+        const CacheState cache_state = state.settings_.cache_state_;
+        const std::vector<FlushRegion>& flush_regions = state.settings_.flush_regions_;
+        const std::size_t max_retries = state.settings_.max_migration_retries_;
+        const std::size_t max_discards = state.settings_.max_discard_retries_;
+        std::uint64_t summary_time = state.summary_time_, summary_corrected_time = state.summary_corrected_time_;
+        std::uint64_t counters_before[PerfCounters::kMaxEvents]{}, counters_after[PerfCounters::kMaxEvents]{};
+        std::size_t retries = 0, discards = 0;
+
+        TimePoint start, end;
+        const std::size_t last = state.samples_number_ + count;
+        std::size_t r = state.samples_number_;
+        while (r < last) {
+            setup();
+            if (cache_state != CacheState::kWarm) {
+                cache_controller_.Apply(cache_state, flush_regions);
+            }
+            if (counters != nullptr) {
+                counters->Read(counters_before);
+            }
+            bool migrated = false;
             if constexpr (CheckCpuMigration) {
                 CpuId cpu_number0{0}, cpu_number1{1};
                 start = clock_.StartTime(cpu_number0);
-                code.operator()();
+                details::InvokeAndSink(code);
                 end = clock_.EndTime(cpu_number1);
-                if (cpu_number0 != cpu_number1) {
-                    continue;
-                }
+                migrated = cpu_number0 != cpu_number1;
             } else {
                 start = clock_.StartTime();
-                code.operator()();
+                details::InvokeAndSink(code);
                 end = clock_.EndTime();
             }
+            if (counters != nullptr) {
+                counters->Read(counters_after);
+            }
+            teardown();
 
-            if (LIKELY(end > start)) {
+            if (LIKELY(!migrated && end > start && end - start > tsc_overhead_)) {
                 TimePoint time = end - start;
-                if (time > tsc_overhead_) {
-                    summary_time += time;
+                summary_time += time;
+                summary_corrected_time += Correct(time, applied_overhead);
+                if (record_samples) {
+                    samples_[r] = time;
+                }
+                for (std::size_t e = 0; e < events_number; ++e) {
+                    std::uint64_t sample_count = counters_after[e] - counters_before[e];
+                    state.counter_sums_[e] += sample_count;
+                    if (record_samples) {
+                        counter_samples_[r * events_number + e] = sample_count;
+                    }
+                }
+                ++r;
+                retries = discards = 0;
+                continue;
+            }
+            ++state.discarded_number_;
+            if (migrated) {
+                ++state.migrations_number_;
+                if (UNLIKELY(++retries > max_retries)) {
+                    state.aborted_ = true;
+                    break;
+                }
+            }
+            if (UNLIKELY(++discards > max_discards)) {
+                state.aborted_ = state.discard_limit_ = true;
+                break;
+            }
+        }
+        state.samples_number_ = r;
+        state.summary_time_ = summary_time;
+        state.summary_corrected_time_ = summary_corrected_time;
+    }
+
+    template<bool CheckCpuMigration, Barrier BarrierType, typename Clock>
+    TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::Result TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::FinishRun(
+            const RunState& state) {
+        const Settings& settings = state.settings_;
+        const std::size_t samples_number = std::max<std::size_t>(state.samples_number_, 1);
+        const std::size_t batch_size = state.batch_size_;
+        const std::size_t events_number = state.events_number_;
+        const TimePoint applied_overhead = state.applied_overhead_;
+
+        TSCBenchmarking::Result result{};
+        result.samples_number_ = state.samples_number_;
+        result.cache_state_ = settings.cache_state_;
+        result.noise_ = state.noise_;
+        result.noise_ += ProbeNoise(settings);
+        result.noise_score_ = result.noise_.StolenFraction();
+        result.noisy_ = result.noise_score_ > settings.max_noise_score_;
+        result.core_type_ = GetCoreType(settings.cpu_);
+        result.migrations_number_ = state.migrations_number_;
+        result.discarded_number_ = state.discarded_number_;
+        const std::size_t attempts_number = state.samples_number_ + state.discarded_number_;
+        result.discard_rate_ = attempts_number > 0
+                               ? static_cast<double>(state.discarded_number_) / static_cast<double>(attempts_number) : 0.0;
+        result.aborted_ = state.aborted_;
+        if (state.aborted_ && state.discard_limit_) {
+            std::cerr << "[Warning] Run stopped after more than " << settings.max_discard_retries_
+                      << " discarded samples in a row on CPU " << settings.cpu_ << " - code time "
+                      << "is non-monotonic or at/below TSC overhead of " << tsc_overhead_
+                      << " ticks (re-measure with MeasureOverheadOn()) (" << state.samples_number_ << " of "
+                      << settings.cycles_number_ << " samples taken, " << state.discarded_number_
+                      << " discarded)" << std::endl;
+        } else if (state.aborted_) {
+            std::cerr << "[Warning] Run stopped after more than " << settings.max_migration_retries_
+                      << " CPU migrations in a row on CPU " << settings.cpu_ << " (" << state.samples_number_
+                      << " of " << settings.cycles_number_ << " samples taken, " << state.migrations_number_
+                      << " migrations)" << std::endl;
+        }
+        result.time_ = state.summary_time_ / samples_number;
+        result.overhead_ = tsc_overhead_;
+        result.time_ns_ = calibration_.ToNanos(result.time_);
+        result.overhead_ns_ = calibration_.ToNanos(result.overhead_);
+        result.overhead_correction_ = settings.overhead_correction_;
+        result.applied_overhead_ = applied_overhead;
+        result.corrected_time_ = state.summary_corrected_time_ / samples_number;
+        result.corrected_time_ns_ = calibration_.ToNanos(result.corrected_time_);
+        result.clock_overhead_ = clock_overhead_;
+        result.batch_size_ = batch_size;
+        result.per_op_time_ = static_cast<double>(state.summary_corrected_time_) / static_cast<double>(samples_number * batch_size);
+        result.per_op_time_ns_ = calibration_.ToFractionalNanos(result.per_op_time_);
+        result.amortized_overhead_ = static_cast<double>(tsc_overhead_) / static_cast<double>(batch_size);
+        if (state.counters_ != nullptr) {
+            CounterResult& counter_result = result.counters_;
+            counter_result.events_ = state.counters_->Events();
+            counter_result.baseline_.assign(state.counter_baseline_, state.counter_baseline_ + events_number);
+            counter_result.per_call_.resize(events_number);
+            for (std::size_t e = 0; e < events_number; ++e) {
+                double per_sample = static_cast<double>(state.counter_sums_[e]) / static_cast<double>(samples_number);
+                counter_result.per_call_[e] = std::max(0.0, per_sample - static_cast<double>(state.counter_baseline_[e]))
+                                              / static_cast<double>(batch_size);
+            }
+            if (settings.record_samples_) {
+                counter_result.samples_.assign(counter_samples_.begin(),
+                                               counter_samples_.begin() + static_cast<std::ptrdiff_t>(state.samples_number_ * events_number));
+            }
+            counter_result.valid_ = state.counters_->IsScheduled();
+            if (!counter_result.valid_) {
+                std::cerr << "[Warning] Performance counters were not scheduled on PMU for the whole run" << std::endl;
+            }
+        }
+        if (settings.record_samples_) {
+            std::span<TimePoint> samples{samples_.data(), state.samples_number_};
+            result.samples_.assign(samples.begin(), samples.end());
+            result.distribution_ = ComputeDistribution(samples);
+            if (applied_overhead == 0) {
+                result.corrected_distribution_ = result.distribution_;
+            } else {
+                std::transform(result.samples_.begin(), result.samples_.end(), samples.begin(),
+                               [applied_overhead](TimePoint time) { return Correct(time, applied_overhead); });
+                result.corrected_distribution_ = ComputeDistribution(samples);
+            }
+            if (settings.outliers_.enabled_) {
+                // samples holds corrected values reordered by ComputeDistribution(), order does not
+                // matter without per-sample tags
+                result.outliers_ = ClassifyOutliers(samples, settings.outliers_, GetGapTicks(settings));
+            }
+        }
+        return result;
+    }
+
+    template<bool CheckCpuMigration, Barrier BarrierType, typename Clock>
+    template<typename Code>
+    std::vector<typename TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::ParallelResult>
+    TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::RunParallel(Code&& code, const std::vector<int>& cpus,
+                                                                 TSCBenchmarking::Settings settings) {
+        std::vector<ParallelResult> curve;
+        curve.reserve(cpus.size());
+        for (std::size_t threads_number = 1; threads_number <= cpus.size(); ++threads_number) {
+            std::vector<int> step_cpus(cpus.begin(), cpus.begin() + static_cast<std::ptrdiff_t>(threads_number));
+            curve.push_back(RunParallelStep(code, step_cpus, settings));
+
+            double single_thread = curve.front().aggregate_throughput_;
+            if (single_thread > 0.0) {
+                curve.back().scaling_efficiency_ = curve.back().aggregate_throughput_ / (single_thread * threads_number);
+            }
+        }
+        return curve;
+    }
+
+    template<bool CheckCpuMigration, Barrier BarrierType, typename Clock>
+    template<typename Code>
+    std::vector<typename TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::ParallelResult>
+    TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::RunParallel(Code&& code, TSCBenchmarking::Settings settings) {
+        return RunParallel(code, details::GetPlacementCpuList(), settings);
+    }
+
+    template<bool CheckCpuMigration, Barrier BarrierType, typename Clock>
+    template<std::size_t StreamLength, typename Code>
+    TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::ThroughputResult
+    TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::RunThroughput(Code&& code, TSCBenchmarking::Settings settings) {
+        static constexpr std::size_t kUnroll = StreamLength < 8 ? StreamLength : 8;
+        static_assert(StreamLength > 0 && StreamLength % kUnroll == 0, "Stream length must be multiple of 8");
+
+        ThroughputResult result{};
+        result.stream_length_ = StreamLength;
+        settings.record_samples_ = true;
+        if (settings.overhead_correction_ == OverheadCorrection::kNone) {
+            settings.overhead_correction_ = OverheadCorrection::kSubtractMin;
+        }
+        result.latency_ = Run(code, settings);  // pins thread to settings.cpu_
+        result.latency_time_ = static_cast<double>(result.latency_.corrected_distribution_.median_);
+
+        // Unfenced Rdtsc() pair cost; reads may still overlap with stream edges, which
+        // StreamLength amortizes
+        TimePoint pair_overhead = std::numeric_limits<TimePoint>::max();
+        for (std::size_t i = 0; i < kDefaultCyclesNumber; ++i) {
+            const TimePoint start = details::Rdtsc();
+            const TimePoint end = details::Rdtsc();
+            pair_overhead = std::min(pair_overhead, end - start);
+        }
+
+        auto stream = [&code]() FORCE_INLINE_LAMBDA {
+            for (std::size_t i = 0; i < StreamLength; i += kUnroll) {
+                details::InvokeUnrolled(code, std::make_index_sequence<kUnroll>{});
+            }
+        };
+        stream();
+        std::vector<TimePoint> streams(std::max<std::size_t>(settings.cycles_number_, 1));
+        for (TimePoint& time : streams) {
+            const TimePoint start = details::Rdtsc();
+            stream();
+            const TimePoint end = details::Rdtsc();
+            time = Correct(end - start, pair_overhead);
+        }
+        result.streams_ = ComputeDistribution(streams);
+        result.throughput_time_ = static_cast<double>(result.streams_.median_) / static_cast<double>(StreamLength);
+        if constexpr (kNanosecondClock) {
+            // Stream is timed with Rdtsc() regardless of Clock - report in clock ticks as latency
+            result.throughput_time_ = tsc_calibration_.ToFractionalNanos(result.throughput_time_).count();
+        }
+        result.latency_time_ns_ = calibration_.ToFractionalNanos(result.latency_time_);
+        result.throughput_time_ns_ = calibration_.ToFractionalNanos(result.throughput_time_);
+        result.overlap_ = result.throughput_time_ > 0.0 ? result.latency_time_ / result.throughput_time_ : 0.0;
+        return result;
+    }
+
+    template<bool CheckCpuMigration, Barrier BarrierType, typename Clock>
+    template<typename Code>
+    TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::ParallelResult
+    TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::RunParallelStep(Code& code, const std::vector<int>& cpus,
+                                                                     const Settings& settings) {
+        const std::size_t threads_number = cpus.size();
+        const TimePoint tsc_overhead = tsc_overhead_;
+        const TimePoint applied_overhead = GetAppliedOverhead(settings.overhead_correction_);
+
+        // Everything workers touch is allocated before they start
+        std::vector<std::vector<TimePoint>> samples(threads_number, std::vector<TimePoint>(settings.cycles_number_, 0));
+        std::vector<TimePoint> finish(threads_number, 0);
+        std::vector<char> discard_limit(threads_number, 0);     // Worker stopped on max_discard_retries_
+        details::SpinBarrier barrier{threads_number + 1};
+        alignas(kCacheLineSize) std::atomic<TimePoint> start_gate{0};
+
+        auto worker = [&](std::size_t index) {
+            if (!details::PinThread(cpus[index])) {
+                std::cerr << "[Warning] Failed to pin worker " << index << " to CPU " << cpus[index] << std::endl;
+            }
+            Clock clock{};
+            auto invoke = [&code, index]() FORCE_INLINE_LAMBDA {
+                if constexpr (std::is_invocable_v<Code&, std::size_t>) {
+                    details::InvokeAndSink(code, index);
+                } else {
+                    details::InvokeAndSink(code);
+                }
+            };
+
+            for (std::size_t r = 0; r < settings.cache_warmup_cycles_number_; ++r) {
+                invoke();
+            }
+
+            barrier.ArriveAndWait();
+            TimePoint gate = 0;
+            details::SpinUntil([&]() { return (gate = start_gate.load(std::memory_order_acquire)) != 0; });
+            details::SpinUntil([gate]() { return details::Rdtsc() >= gate; });
+
+            std::vector<TimePoint>& worker_samples = samples[index];
+            TimePoint start, end;
+            std::size_t r = 0, retries = 0, discards = 0;
+            while (r < settings.cycles_number_) {
+                bool migrated = false;
+                if constexpr (CheckCpuMigration) {
+                    CpuId cpu_number0{0}, cpu_number1{1};
+                    start = clock.StartTime(cpu_number0);
+                    invoke();
+                    end = clock.EndTime(cpu_number1);
+                    migrated = cpu_number0 != cpu_number1;
+                } else {
+                    start = clock.StartTime();
+                    invoke();
+                    end = clock.EndTime();
+                }
+
+                if (LIKELY(!migrated && end > start && end - start > tsc_overhead)) {
+                    worker_samples[r] = end - start;
                     ++r;
+                    retries = discards = 0;
+                } else if (migrated && UNLIKELY(++retries > settings.max_migration_retries_)) {
+                    break;
+                } else if (UNLIKELY(++discards > settings.max_discard_retries_)) {
+                    discard_limit[index] = 1;
+                    break;
                 }
             }
+            finish[index] = details::Rdtsc();
+            // Worker that gave up after too many migrations or discards reports samples it took
+            worker_samples.resize(r);
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(threads_number);
+        for (std::size_t i = 0; i < threads_number; ++i) {
+            threads.emplace_back(worker, i);
+        }
+
+        barrier.ArriveAndWait();
+        const auto gate_delay = static_cast<TimePoint>(tsc_calibration_.TicksPerNanosecond() * kStartGateDelayNs);
+        const TimePoint gate = details::Rdtsc() + gate_delay;
+        start_gate.store(gate, std::memory_order_release);
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+
+        ParallelResult result{};
+        result.threads_number_ = threads_number;
+        result.threads_.resize(threads_number);
+        TimePoint last_finish = gate;
+        std::size_t samples_number = 0;
+        for (std::size_t i = 0; i < threads_number; ++i) {
+            ThreadResult& thread_result = result.threads_[i];
+            thread_result.cpu_ = cpus[i];
+            thread_result.elapsed_ = finish[i] > gate ? finish[i] - gate : 0;
+            if (thread_result.elapsed_ > 0) {
+                thread_result.throughput_ = static_cast<double>(samples[i].size()) * tsc_calibration_.Frequency()
+                                            / static_cast<double>(thread_result.elapsed_);
+            }
+            for (TimePoint& sample : samples[i]) {
+                sample = sample > applied_overhead ? sample - applied_overhead : 0;
+            }
+            thread_result.distribution_ = ComputeDistribution(samples[i]);
+            last_finish = std::max(last_finish, finish[i]);
+            samples_number += samples[i].size();
         }
-        return TSCBenchmarking::Result{summary_time / settings.cycles_number_, tsc_overhead_};
+        if (samples_number < settings.cycles_number_ * threads_number) {
+            const bool discarded = std::find(discard_limit.begin(), discard_limit.end(), 1) != discard_limit.end();
+            std::cerr << "[Warning] Parallel workers stopped after more than "
+                      << (discarded ? settings.max_discard_retries_ : settings.max_migration_retries_)
+                      << (discarded ? " discarded samples (non-monotonic or at/below TSC overhead)" : " CPU migrations")
+                      << " in a row (" << samples_number << " of "
+                      << settings.cycles_number_ * threads_number << " samples taken)" << std::endl;
+        }
+        if (last_finish > gate) {
+            result.aggregate_throughput_ = static_cast<double>(samples_number)
+                                           * tsc_calibration_.Frequency() / static_cast<double>(last_finish - gate);
+        }
+        return result;
     }
 
-    template<bool CheckCpuMigration, Barrier BarrierType>
-    std::pair<TimePoint, TimePoint> TSCBenchmarking<CheckCpuMigration, BarrierType>::MeasureOverhead(std::size_t cycles_number) {
+    template<bool CheckCpuMigration, Barrier BarrierType, typename Clock>
+    void TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::MeasureCounterBaseline(PerfCounters& counters,
+                                                                                 std::uint64_t* baseline) {
+        const std::size_t events_number = counters.Events().size();
+        std::uint64_t before[PerfCounters::kMaxEvents]{}, after[PerfCounters::kMaxEvents]{};
+        std::fill(baseline, baseline + events_number, std::numeric_limits<std::uint64_t>::max());
+        TimePoint start, end;
+        for (std::size_t i = 0; i < kDefaultCyclesNumber; ++i) {
+            counters.Read(before);
+            bool valid = Measure(start, end, details::kEmptyCode);
+            counters.Read(after);
+            if (valid) {
+                for (std::size_t e = 0; e < events_number; ++e) {
+                    baseline[e] = std::min(baseline[e], after[e] - before[e]);
+                }
+            }
+        }
+        for (std::size_t e = 0; e < events_number; ++e) {
+            if (baseline[e] == std::numeric_limits<std::uint64_t>::max()) {
+                baseline[e] = 0;
+            }
+        }
+    }
+
+    template<bool CheckCpuMigration, Barrier BarrierType, typename Clock>
+    TimePoint TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::GetAppliedOverhead(OverheadCorrection correction) const noexcept {
+        switch (correction) {
+            case OverheadCorrection::kSubtractMin: return tsc_overhead_;
+            case OverheadCorrection::kSubtractMedian: return tsc_median_overhead_;
+            case OverheadCorrection::kNone: break;
+        }
+        return 0;
+    }
+
+    template<bool CheckCpuMigration, Barrier BarrierType, typename Clock>
+    TimePoint TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::MeasureOverheadOn(int cpu, const Settings& settings) {
+        if (!details::PinThread(cpu)) {
+            std::cerr << "[Warning] Overhead is not re-measured on CPU " << cpu << std::endl;
+            return tsc_overhead_;
+        }
+        CalibrateOverhead(settings);
+        return tsc_overhead_;
+    }
+
+    template<bool CheckCpuMigration, Barrier BarrierType, typename Clock>
+    void TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::CalibrateOverhead(const Settings& settings) {
+        auto overheads = settings.overhead_calibration_ == OverheadCalibration::kStabilized
+                         ? MeasureStabilizedOverhead(kDefaultCyclesNumber * kDefaultRunsNumber, kDefaultCyclesNumber)
+                         : MeasureOverhead();
+        tsc_overhead_ = overheads.first;
+        clock_overhead_ = overheads.second;
+        tsc_median_overhead_ = std::max(tsc_overhead_, MeasureMedianLatency(kDefaultCyclesNumber, details::kEmptyCode));
+    }
+
+    template<bool CheckCpuMigration, Barrier BarrierType, typename Clock>
+    std::pair<TimePoint, TimePoint> TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::MeasureOverhead(std::size_t cycles_number) {
         TimePoint min_tsc_overhead = MeasureMinLatency(cycles_number, details::kEmptyCode);
         TimePoint min_clock_overhead = MeasureMinLatency(cycles_number, kGetTime);
         return {min_tsc_overhead, min_clock_overhead - min_tsc_overhead};
     }
 
-    template<bool CheckCpuMigration, Barrier BarrierType>
-    std::pair<TimePoint, TimePoint> TSCBenchmarking<CheckCpuMigration, BarrierType>::MeasureStabilizedOverhead(
+    template<bool CheckCpuMigration, Barrier BarrierType, typename Clock>
+    std::pair<TimePoint, TimePoint> TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::MeasureStabilizedOverhead(
             std::size_t cycles_number, std::size_t stabilized_threshold) {
         TimePoint min_tsc_overhead = MeasureStabilizedMinLatency(cycles_number,
                                                                  stabilized_threshold,
@@ -279,9 +1549,9 @@ namespace benchmarking {
         return {min_tsc_overhead, min_clock_overhead - min_tsc_overhead};
     }
 
-    template<bool CheckCpuMigration, Barrier BarrierType>
+    template<bool CheckCpuMigration, Barrier BarrierType, typename Clock>
     template<typename Code>
-    TimePoint TSCBenchmarking<CheckCpuMigration, BarrierType>::MeasureMinLatency(std::size_t cycles_number,
+    TimePoint TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::MeasureMinLatency(std::size_t cycles_number,
                                                                                  Code&& code) {
         TimePoint start, end;
         TimePoint min_latency = std::numeric_limits<TimePoint>::max();
@@ -294,9 +1564,24 @@ namespace benchmarking {
         return min_latency;
     }
 
-    template<bool CheckCpuMigration, Barrier BarrierType>
+    template<bool CheckCpuMigration, Barrier BarrierType, typename Clock>
+    template<typename Code>
+    TimePoint TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::MeasureMedianLatency(std::size_t cycles_number,
+                                                                                    Code&& code) {
+        TimePoint start, end;
+        std::vector<TimePoint> latencies(cycles_number);
+        for (std::size_t i = 0; i < cycles_number;) {
+            if (Measure<Code>(start, end, std::forward<Code>(code)) && LIKELY(end > start)) {
+                latencies[i] = end - start;
+                ++i;
+            }
+        }
+        return ComputeDistribution(latencies).median_;
+    }
+
+    template<bool CheckCpuMigration, Barrier BarrierType, typename Clock>
     template<typename Code>
-    TimePoint TSCBenchmarking<CheckCpuMigration, BarrierType>::MeasureStabilizedMinLatency(
+    TimePoint TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::MeasureStabilizedMinLatency(
             std::size_t cycles_number,
             std::size_t stabilized_threshold,
             Code&& code) {
@@ -320,18 +1605,18 @@ namespace benchmarking {
     }
 
 
-    template<bool CheckCpuMigration, Barrier BarrierType>
+    template<bool CheckCpuMigration, Barrier BarrierType, typename Clock>
     template<typename Code>
-    bool TSCBenchmarking<CheckCpuMigration, BarrierType>::Measure(TimePoint& start, TimePoint& end, Code&& code) {
+    bool TSCBenchmarking<CheckCpuMigration, BarrierType, Clock>::Measure(TimePoint& start, TimePoint& end, Code&& code) {
         if constexpr (CheckCpuMigration) {
             uint32_t start_cpu_number{0}, end_cpu_number{1};
             start = clock_.StartTime(start_cpu_number);
-            code();
+            details::InvokeAndSink(code);
             end = clock_.EndTime(end_cpu_number);
             return start_cpu_number == end_cpu_number;
         } else {
             start = clock_.StartTime();
-            code();
+            details::InvokeAndSink(code);
             end = clock_.EndTime();
             return true;
         }
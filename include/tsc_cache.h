@@ -0,0 +1,275 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Linux system includes
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "tsc_cpu.h"
+#include "utils/compiler.h"
+#include "utils/types.h"
+
+namespace benchmarking {
+
+    /// Cache state code under measurement starts in (prepared outside timed region before every sample)
+    enum class CacheState {
+        kWarm,              ///< No preparation - data stays in cache between samples
+        kColdFlush,         ///< Flush Settings::flush_regions_ from all cache levels (CLFLUSHOPT/CLFLUSH)
+        kColdThrash,        ///< Evict caches by touching buffer larger than LLC
+        kTlbCold            ///< Evict TLB entries by touching one line on each of many pages
+    };
+
+    /// Human-readable name of cache state
+    inline const char* ToString(CacheState state) noexcept {
+        switch (state) {
+            case CacheState::kWarm: return "warm";
+            case CacheState::kColdFlush: return "cold_flush";
+            case CacheState::kColdThrash: return "cold_thrash";
+            case CacheState::kTlbCold: return "tlb_cold";
+        }
+        return "unknown";
+    }
+
+    /// Memory region flushed by CacheState::kColdFlush
+    class FlushRegion {
+    public:
+        /// First byte of region
+        const void* data_{nullptr};
+
+        /// Size of region in bytes
+        std::size_t size_{0};
+    };
+
+    /// Data or unified cache level of CPU
+    class CacheLevel {
+    public:
+        /// Cache level (1 - L1, 2 - L2, ...)
+        int level_{0};
+
+        /// Cache size in bytes
+        std::size_t size_bytes_{0};
+    };
+
+    namespace details {
+        /// Data and unified caches in order of level (CPUID leaf 4/0x8000001D, sysfs of cpu0 as fallback)
+        inline std::vector<CacheLevel> ReadCacheLevels() {
+            std::vector<CacheLevel> levels;
+            for (const CpuCache& cache : CpuInfo::Instance().Caches()) {
+                if (cache.type_ == 1 || cache.type_ == 3) {
+                    levels.push_back(CacheLevel{cache.level_, cache.size_bytes_});
+                }
+            }
+            const bool from_sysfs = levels.empty();
+            for (int index = 0; from_sysfs; ++index) {
+                const std::string path = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + "/";
+                std::ifstream level_file{path + "level"}, type_file{path + "type"}, size_file{path + "size"};
+                if (!level_file || !type_file || !size_file) {
+                    break;
+                }
+                CacheLevel level{};
+                std::string type, size;
+                level_file >> level.level_;
+                type_file >> type;
+                size_file >> size;
+                if (type == "Instruction" || size.empty()) {
+                    continue;
+                }
+                level.size_bytes_ = std::stoull(size);
+                switch (size.back()) {
+                    case 'K': level.size_bytes_ <<= 10; break;
+                    case 'M': level.size_bytes_ <<= 20; break;
+                    case 'G': level.size_bytes_ <<= 30; break;
+                    default: break;
+                }
+                levels.push_back(level);
+            }
+            std::sort(levels.begin(), levels.end(), [](const CacheLevel& lhs, const CacheLevel& rhs) {
+                return lhs.level_ < rhs.level_;
+            });
+            return levels;
+        }
+
+        /// Check if CLFLUSHOPT is supported (CPUID leaf 7 EBX bit 23)
+        inline bool IsClflushoptEnabled() noexcept {
+            return CpuInfo::Instance().MaxLeaf() >= 7 && (QueryCpuId(7).ebx_ & (1u << 23)) != 0;
+        }
+
+        /// Flush cache line containing address (weakly ordered, needs SFence())
+        FORCE_INLINE void Clflushopt(const void* address) noexcept {
+            __asm__ __volatile__("clflushopt %0" :: "m"(*static_cast<const volatile char*>(address)) : "memory");
+        }
+
+        /// Flush cache line containing address (ordered with respect to writes)
+        FORCE_INLINE void Clflush(const void* address) noexcept {
+            __asm__ __volatile__("clflush %0" :: "m"(*static_cast<const volatile char*>(address)) : "memory");
+        }
+
+        /// Store fence - orders stores and CLFLUSHOPT
+        FORCE_INLINE void SFence() noexcept {
+            __asm__ __volatile__("sfence" ::: "memory");
+        }
+
+        /// Anonymous mapping of small pages only (madvise(MADV_NOHUGEPAGE) keeps THP "always" away)
+        class SmallPageBuffer {
+        public:
+            SmallPageBuffer() = default;
+            SmallPageBuffer(const SmallPageBuffer&) = delete;
+            SmallPageBuffer& operator=(const SmallPageBuffer&) = delete;
+            SmallPageBuffer(SmallPageBuffer&& other) noexcept
+                    : data_{std::exchange(other.data_, nullptr)}, size_{std::exchange(other.size_, 0)} {}
+            SmallPageBuffer& operator=(SmallPageBuffer&& other) noexcept {
+                if (this != &other) {
+                    Release();
+                    data_ = std::exchange(other.data_, nullptr);
+                    size_ = std::exchange(other.size_, 0);
+                }
+                return *this;
+            }
+
+            ~SmallPageBuffer() { Release(); }
+
+            /**
+             * @brief Map and prefault buffer
+             * @param size Size in bytes
+             * @return false if mapping failed (buffer is empty)
+             */
+            bool Map(std::size_t size) {
+                Release();
+                void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (memory == MAP_FAILED) {
+                    return false;
+                }
+                if (madvise(memory, size, MADV_NOHUGEPAGE) != 0) {
+                    std::cerr << "[Warning] madvise(MADV_NOHUGEPAGE) failed - TLB-cold buffer may use huge pages" << std::endl;
+                }
+                data_ = static_cast<std::uint8_t*>(memory);
+                size_ = size;
+                std::fill_n(data_, size_, std::uint8_t{0});
+                return true;
+            }
+
+            [[nodiscard]] std::uint8_t* data() noexcept { return data_; }
+            [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+        private:
+            void Release() noexcept {
+                if (data_ != nullptr) {
+                    munmap(data_, size_);
+                }
+                data_ = nullptr;
+                size_ = 0;
+            }
+
+            std::uint8_t* data_{nullptr};
+            std::size_t size_{0};
+        };
+
+        /**
+         * @brief Prepares cache state before every sample
+         *
+         * Eviction buffers are allocated and touched on first use of a policy, so later runs
+         * only pay for eviction itself.
+         */
+        class CacheController {
+        public:
+            /// Pages touched by CacheState::kTlbCold (exceeds second-level TLB of current CPUs)
+            static constexpr std::size_t kTlbThrashPages = 8192;
+
+            CacheController() : clflushopt_{IsClflushoptEnabled()} {}
+
+            /**
+             * @brief Allocate eviction buffer of policy
+             * @param state Cache state policy
+             * @param thrash_bytes Size of kColdThrash buffer (0 - 1.5x LLC size)
+             * @param regions Regions flushed by kColdFlush
+             */
+            void Prepare(CacheState state, std::size_t thrash_bytes, const std::vector<FlushRegion>& regions) {
+                if (state == CacheState::kColdThrash) {
+                    if (thrash_bytes == 0) {
+                        std::vector<CacheLevel> levels = ReadCacheLevels();
+                        thrash_bytes = levels.empty() ? kDefaultThrashBytes : levels.back().size_bytes_ * 3 / 2;
+                    }
+                    if (thrash_buffer_.size() != thrash_bytes) {
+                        thrash_buffer_.assign(thrash_bytes, 0);
+                    }
+                } else if (state == CacheState::kTlbCold) {
+                    const auto page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+                    if (tlb_buffer_.size() != kTlbThrashPages * page_size && !tlb_buffer_.Map(kTlbThrashPages * page_size)) {
+                        std::cerr << "[Warning] Failed to map TLB-cold buffer - TLB is not evicted" << std::endl;
+                    }
+                    page_size_ = page_size;
+                } else if (state == CacheState::kColdFlush && regions.empty()) {
+                    std::cerr << "[Warning] Cold flush policy without flush regions - nothing is flushed" << std::endl;
+                }
+            }
+
+            /// Bring caches into state (called outside timed region)
+            FORCE_INLINE void Apply(CacheState state, const std::vector<FlushRegion>& regions) noexcept {
+                switch (state) {
+                    case CacheState::kWarm:
+                        break;
+                    case CacheState::kColdFlush:
+                        Flush(regions);
+                        break;
+                    case CacheState::kColdThrash:
+                        Touch(thrash_buffer_, kCacheLineSize);
+                        break;
+                    case CacheState::kTlbCold:
+                        Touch(tlb_buffer_, page_size_);
+                        break;
+                }
+            }
+
+        private:
+            /// Fallback size of thrash buffer if LLC size is unknown
+            static constexpr std::size_t kDefaultThrashBytes = 64u << 20;
+
+            void Flush(const std::vector<FlushRegion>& regions) noexcept {
+                for (const FlushRegion& region : regions) {
+                    auto first = reinterpret_cast<std::uintptr_t>(region.data_) & ~(kCacheLineSize - 1);
+                    auto last = reinterpret_cast<std::uintptr_t>(region.data_) + region.size_;
+                    for (std::uintptr_t line = first; line < last; line += kCacheLineSize) {
+                        if (clflushopt_) {
+                            Clflushopt(reinterpret_cast<const void*>(line));
+                        } else {
+                            Clflush(reinterpret_cast<const void*>(line));
+                        }
+                    }
+                }
+                if (clflushopt_) {
+                    SFence();
+                } else {
+                    MFence();
+                }
+            }
+
+            /// Write one byte every stride bytes (dirty lines are evicted from all levels)
+            template<typename Buffer>
+            static void Touch(Buffer& buffer, std::size_t stride) noexcept {
+                std::uint8_t* data = buffer.data();
+                // Line offset rotates with page so touched lines do not all map to the same cache set
+                const std::size_t offset_step = stride > kCacheLineSize ? kCacheLineSize : 0;
+                std::size_t offset = 0;
+                for (std::size_t i = 0; i + stride <= buffer.size(); i += stride) {
+                    ++data[i + offset];
+                    offset = (offset + offset_step) % stride;
+                }
+                __asm__ __volatile__("" :: "r"(data) : "memory");
+                MFence();
+            }
+
+            std::vector<std::uint8_t> thrash_buffer_{};     ///< Buffer larger than LLC
+            SmallPageBuffer tlb_buffer_{};                  ///< kTlbThrashPages small pages
+            std::size_t page_size_{4096};                   ///< Stride of TLB thrash
+            bool clflushopt_{false};                        ///< CLFLUSHOPT is available
+        };
+    } // namespace details
+
+} // namespace benchmarking
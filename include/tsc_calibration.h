@@ -0,0 +1,202 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+
+#include "tsc_cpu.h"
+#include "utils/compiler.h"
+#include "utils/types.h"
+
+namespace benchmarking {
+
+    /// Source of the TSC frequency used for tick to nanosecond conversion
+    enum class CalibrationSource {
+        kNone,              ///< Not calibrated - one tick is reported as one nanosecond
+        kCpuIdCrystal,      ///< CPUID leaf 0x15 (crystal clock and TSC/crystal ratio) - exact
+        kClockRegression,   ///< Regression of Rdtsc() against CLOCK_MONOTONIC_RAW
+        kCpuIdBaseFrequency,///< CPUID leaf 0x16 nominal base frequency - approximate
+        kHypervisor,        ///< Hypervisor timing leaf 0x40000010 - exact for guest TSC
+        kNanosecondClock    ///< Clock ticks are nanoseconds (VdsoClock) - identity conversion
+    };
+
+    /// Human-readable name of calibration source
+    inline const char* ToString(CalibrationSource source) noexcept {
+        switch (source) {
+            case CalibrationSource::kCpuIdCrystal: return "CPUID 0x15";
+            case CalibrationSource::kClockRegression: return "CLOCK_MONOTONIC_RAW regression";
+            case CalibrationSource::kCpuIdBaseFrequency: return "CPUID 0x16";
+            case CalibrationSource::kHypervisor: return "CPUID 0x40000010";
+            case CalibrationSource::kNanosecondClock: return "nanosecond clock";
+            case CalibrationSource::kNone: break;
+        }
+        return "none";
+    }
+
+    /// TSC frequency calibration with fixed-point tick to nanosecond conversion
+    ///
+    /// Conversion is a single 64x64->128 multiply and shift, so it can be used on hot paths.
+    class TSCCalibration {
+    public:
+        /// Calibrate TSC frequency of current host
+        /// Tries CPUID leaf 0x15, then hypervisor leaf 0x40000010, then clock regression, then CPUID leaf 0x16
+        static TSCCalibration Calibrate() noexcept;
+
+        /// Build calibration from known TSC frequency
+        /// @param tsc_hz TSC frequency in Hz (must be > 0)
+        /// @param source Where the frequency comes from
+        static TSCCalibration FromFrequency(double tsc_hz, CalibrationSource source) noexcept {
+            TSCCalibration calibration{};
+            if (tsc_hz > 0.0) {
+                calibration.tsc_hz_ = tsc_hz;
+                calibration.multiplier_ = static_cast<std::uint64_t>(1e9 / tsc_hz * static_cast<double>(1ull << kShift) + 0.5);
+                calibration.source_ = source;
+            }
+            return calibration;
+        }
+
+        /// Convert TSC ticks to nanoseconds count
+        [[nodiscard]] FORCE_INLINE std::uint64_t ToNanosCount(TimePoint ticks) const noexcept {
+            return static_cast<std::uint64_t>((static_cast<details::UInt128>(ticks) * multiplier_) >> kShift);
+        }
+
+        /// Convert TSC ticks to nanoseconds
+        [[nodiscard]] FORCE_INLINE std::chrono::nanoseconds ToNanos(TimePoint ticks) const noexcept {
+            return std::chrono::nanoseconds{static_cast<std::chrono::nanoseconds::rep>(ToNanosCount(ticks))};
+        }
+
+        /// Convert fractional TSC ticks (e.g. averages) to fractional nanoseconds
+        [[nodiscard]] std::chrono::duration<double, std::nano> ToFractionalNanos(double ticks) const noexcept {
+            return std::chrono::duration<double, std::nano>{ticks * 1e9 / tsc_hz_};
+        }
+
+        /// TSC frequency in Hz (1 GHz if uncalibrated, so conversions never divide by or scale to 0)
+        [[nodiscard]] double Frequency() const noexcept { return tsc_hz_; }
+
+        /// Number of TSC ticks per nanosecond (1 if uncalibrated)
+        [[nodiscard]] double TicksPerNanosecond() const noexcept { return tsc_hz_ / 1e9; }
+
+        /// Source of calibration
+        [[nodiscard]] CalibrationSource Source() const noexcept { return source_; }
+
+        /// Check if calibration was performed
+        [[nodiscard]] bool IsCalibrated() const noexcept { return source_ != CalibrationSource::kNone; }
+
+    private:
+        static constexpr unsigned kShift = 32;                         ///< Fixed-point fraction bits
+        static constexpr std::size_t kRegressionPoints = 64;           ///< Points in clock regression
+        static constexpr std::size_t kRegressionTries = 16;            ///< Reads per point (tightest kept)
+        static constexpr std::int64_t kRegressionStepNs = 200'000;     ///< Spacing between points
+
+        static double CpuIdCrystalFrequency() noexcept;
+        static double CpuIdBaseFrequency() noexcept;
+        static double ClockRegressionFrequency() noexcept;
+
+        std::uint64_t multiplier_{1ull << kShift};   ///< Nanoseconds per tick in 32.32 fixed point
+        double tsc_hz_{1e9};                         ///< TSC frequency in Hz
+        CalibrationSource source_{CalibrationSource::kNone};
+    };
+
+
+    // Implementation
+    inline TSCCalibration TSCCalibration::Calibrate() noexcept {
+        if (double hz = CpuIdCrystalFrequency(); hz > 0.0) {
+            return FromFrequency(hz, CalibrationSource::kCpuIdCrystal);
+        }
+        if (double hz = details::CpuInfo::Instance().HypervisorTscHz(); hz > 0.0) {
+            return FromFrequency(hz, CalibrationSource::kHypervisor);
+        }
+        if (double hz = ClockRegressionFrequency(); hz > 0.0) {
+            return FromFrequency(hz, CalibrationSource::kClockRegression);
+        }
+        if (double hz = CpuIdBaseFrequency(); hz > 0.0) {
+            return FromFrequency(hz, CalibrationSource::kCpuIdBaseFrequency);
+        }
+        return TSCCalibration{};
+    }
+
+    inline double TSCCalibration::CpuIdCrystalFrequency() noexcept {
+        return details::CpuInfo::Instance().TscHz();
+    }
+
+    inline double TSCCalibration::CpuIdBaseFrequency() noexcept {
+        if (details::CpuInfo::Instance().MaxLeaf() < 0x16) {
+            return 0.0;
+        }
+        // EAX[15:0] - processor base frequency in MHz
+        return static_cast<double>(details::QueryCpuId(0x16).eax_ & 0xFFFF) * 1e6;
+    }
+
+    inline double TSCCalibration::ClockRegressionFrequency() noexcept {
+        auto now_ns = [](std::int64_t& ns) {
+            timespec ts{};
+            if (clock_gettime(CLOCK_MONOTONIC_RAW, &ts) != 0) {
+                return false;
+            }
+            ns = static_cast<std::int64_t>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+            return true;
+        };
+
+        double x[kRegressionPoints];   // clock nanoseconds relative to first point
+        double y[kRegressionPoints];   // TSC ticks relative to first point
+        std::int64_t ns_origin = 0, deadline = 0;
+        TimePoint tsc_origin = 0;
+
+        for (std::size_t point = 0; point < kRegressionPoints; ++point) {
+            // Keep read whose Rdtsc() bracket around clock_gettime() is tightest
+            TimePoint best_bracket = ~TimePoint{0}, best_tsc = 0;
+            std::int64_t best_ns = 0;
+            for (std::size_t attempt = 0; attempt < kRegressionTries; ++attempt) {
+                std::int64_t ns = 0;
+                TimePoint before = details::Rdtsc();
+                bool ok = now_ns(ns);
+                TimePoint after = details::Rdtsc();
+                if (!ok) {
+                    return 0.0;
+                }
+                if (after > before && after - before < best_bracket) {
+                    best_bracket = after - before;
+                    best_tsc = before + (after - before) / 2;
+                    best_ns = ns;
+                }
+            }
+            if (best_tsc == 0) {
+                return 0.0;
+            }
+
+            if (point == 0) {
+                ns_origin = best_ns;
+                tsc_origin = best_tsc;
+            }
+            x[point] = static_cast<double>(best_ns - ns_origin);
+            y[point] = static_cast<double>(static_cast<std::int64_t>(best_tsc - tsc_origin));
+
+            deadline = best_ns + kRegressionStepNs;
+            for (std::int64_t ns = best_ns; ns < deadline;) {
+                if (!now_ns(ns)) {
+                    return 0.0;
+                }
+            }
+        }
+
+        // Least squares slope: ticks per nanosecond
+        double mean_x = 0.0, mean_y = 0.0;
+        for (std::size_t i = 0; i < kRegressionPoints; ++i) {
+            mean_x += x[i];
+            mean_y += y[i];
+        }
+        mean_x /= kRegressionPoints;
+        mean_y /= kRegressionPoints;
+
+        double sxy = 0.0, sxx = 0.0;
+        for (std::size_t i = 0; i < kRegressionPoints; ++i) {
+            sxy += (x[i] - mean_x) * (y[i] - mean_y);
+            sxx += (x[i] - mean_x) * (x[i] - mean_x);
+        }
+        if (sxx <= 0.0 || sxy <= 0.0) {
+            return 0.0;
+        }
+        return sxy / sxx * 1e9;
+    }
+
+} // namespace benchmarking
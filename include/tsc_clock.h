@@ -1,5 +1,10 @@
 #pragma once
 
+#include <concepts>
+#include <ctime>
+
+#include <sched.h>
+
 #include "tsc_cpu.h"
 #include "utils/compiler.h"
 #include "utils/types.h"
@@ -13,9 +18,61 @@ namespace benchmarking {
         kLFence,    ///< Load fence barrier - prevents load reordering  
         kMFence,    ///< Memory fence barrier - prevents all memory reordering
         kRdtscp,    ///< RDTSCP barrier - Intel recommended approach
-        kTwoCpuId   ///< Double CPUID barrier - maximum accuracy, higher overhead
+        kTwoCpuId,  ///< Double CPUID barrier - maximum accuracy, higher overhead
+        kAuto       ///< Cheapest serializing fence of host, resolved once from CpuInfo (see SelectFence())
     };
 
+    /// Human-readable name of barrier type
+    inline const char* ToString(Barrier barrier) noexcept {
+        switch (barrier) {
+            case Barrier::kOneCpuId: return "cpuid";
+            case Barrier::kLFence: return "lfence";
+            case Barrier::kMFence: return "mfence";
+            case Barrier::kRdtscp: return "rdtscp";
+            case Barrier::kTwoCpuId: return "twocpuid";
+            case Barrier::kAuto: return "auto";
+        }
+        return "unknown";
+    }
+
+    namespace details {
+        /// Fence instruction used by TSCClock<Barrier::kAuto>
+        enum class FenceKind {
+            kLFence,    ///< LFENCE (dispatch serializing on Intel and on AMD with leaf 0x80000021 EAX bit 2)
+            kMFence,    ///< MFENCE (orders RDTSC on AMD when LFENCE mode is unknown)
+            kCpuId      ///< CPUID (always serializing, traps to VMM under hypervisor)
+        };
+
+        inline const char* ToString(FenceKind fence) noexcept {
+            switch (fence) {
+                case FenceKind::kLFence: return "lfence";
+                case FenceKind::kMFence: return "mfence";
+                case FenceKind::kCpuId: return "cpuid";
+            }
+            return "unknown";
+        }
+
+        /**
+         * @brief Cheapest fence that still orders RDTSC on this host (resolved once per process)
+         *
+         * CPUID costs ~100 cycles on bare metal and a VM exit (microseconds) under a hypervisor, so
+         * it is used only when neither LFENCE nor MFENCE is known to serialize dispatch.
+         */
+        inline FenceKind SelectFence() noexcept {
+            static const FenceKind fence = []() {
+                const CpuInfo& info = CpuInfo::Instance();
+                if (info.IsLFenceSerializing()) {
+                    return FenceKind::kLFence;
+                }
+                if (info.Vendor() == "AuthenticAMD" || info.Vendor() == "HygonGenuine") {
+                    return FenceKind::kMFence;
+                }
+                return FenceKind::kCpuId;
+            }();
+            return fence;
+        }
+    } // namespace details
+
     /// High-precision TSC-based clock with configurable memory barriers
     /// @tparam BarrierType Type of memory barrier to use for instruction ordering
     template<Barrier BarrierType = Barrier::kOneCpuId>
@@ -177,4 +234,107 @@ namespace benchmarking {
         }
     };
 
+    /// Specialization for automatically selected barrier
+    /// Brackets every timestamp with fence from details::SelectFence(), so no CPUID is executed on
+    /// hosts where LFENCE/MFENCE serialize (no VM exits under hypervisor)
+    template<>
+    class TSCClock<Barrier::kAuto> {
+    public:
+        TSCClock() noexcept : fence_{details::SelectFence()} {}
+
+        FORCE_INLINE TimePoint StartTime() noexcept {
+            Fence();
+            TimePoint time = details::Rdtsc();
+            Fence();
+            return time;
+        }
+
+        FORCE_INLINE TimePoint StartTime(CpuId& cpu_number) noexcept {
+            Fence();
+            TimePoint time = details::Rdtscp(cpu_number);
+            Fence();
+            return time;
+        }
+
+        FORCE_INLINE TimePoint EndTime() noexcept {
+            Fence();
+            TimePoint time = details::Rdtsc();
+            Fence();
+            return time;
+        }
+
+        FORCE_INLINE TimePoint EndTime(CpuId& cpu_number) noexcept {
+            TimePoint time = details::Rdtscp(cpu_number);
+            Fence();
+            return time;
+        }
+
+        /// Fence selected for host
+        [[nodiscard]] details::FenceKind SelectedFence() const noexcept { return fence_; }
+
+    private:
+        FORCE_INLINE void Fence() noexcept {
+            // fence_ is constant for process lifetime, branch is always predicted
+            switch (fence_) {
+                case details::FenceKind::kLFence: details::LFence(); break;
+                case details::FenceKind::kMFence: details::MFence(); break;
+                case details::FenceKind::kCpuId: details::CpuId(); break;
+            }
+        }
+
+        details::FenceKind fence_;
+    };
+
+    /**
+     * @brief Clock backed by vDSO clock_gettime() - ticks are nanoseconds
+     *
+     * Fallback for hosts where RDTSC traps, is offset per vCPU or is scaled by hypervisor. With
+     * kvm-clock (or Hyper-V TSC page) as kernel clocksource the vDSO reads paravirtual clock page,
+     * so this is also the supported kvm-clock/pvclock reader from user space. Costs ~20-50 ns per
+     * read and is not serializing; resolution is 1 ns.
+     *
+     * @tparam ClockId POSIX clock (CLOCK_MONOTONIC_RAW - not slewed by NTP)
+     */
+    template<clockid_t ClockId = CLOCK_MONOTONIC_RAW>
+    class VdsoClock {
+    public:
+        /// Ticks are nanoseconds, TSC calibration does not apply
+        static constexpr bool kNanosecondTicks = true;
+
+        FORCE_INLINE TimePoint StartTime() noexcept { return Now(); }
+
+        FORCE_INLINE TimePoint StartTime(CpuId& cpu_number) noexcept {
+            cpu_number = static_cast<CpuId>(sched_getcpu());
+            return Now();
+        }
+
+        FORCE_INLINE TimePoint EndTime() noexcept { return Now(); }
+
+        FORCE_INLINE TimePoint EndTime(CpuId& cpu_number) noexcept {
+            TimePoint time = Now();
+            cpu_number = static_cast<CpuId>(sched_getcpu());
+            return time;
+        }
+
+    private:
+        static FORCE_INLINE TimePoint Now() noexcept {
+            timespec ts{};
+            clock_gettime(ClockId, &ts);
+            return static_cast<TimePoint>(ts.tv_sec) * 1'000'000'000 + static_cast<TimePoint>(ts.tv_nsec);
+        }
+    };
+
+    /// Requirements of clock used by TSCBenchmarking (TSCClock, VdsoClock or user-provided)
+    template<typename ClockType>
+    concept BenchmarkClock = std::default_initializable<ClockType> && requires(ClockType clock, CpuId& cpu_number) {
+        { clock.StartTime() } -> std::same_as<TimePoint>;
+        { clock.EndTime() } -> std::same_as<TimePoint>;
+        { clock.StartTime(cpu_number) } -> std::same_as<TimePoint>;
+        { clock.EndTime(cpu_number) } -> std::same_as<TimePoint>;
+    };
+
+    /// True if clock ticks are nanoseconds (ClockType::kNanosecondTicks), false for TSC ticks
+    template<typename ClockType>
+    inline constexpr bool kIsNanosecondClock = requires { requires ClockType::kNanosecondTicks; };
+
 } // namespace benchmarking
@@ -0,0 +1,281 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "tsc_cache.h"
+#include "tsc_calibration.h"
+#include "utils/compiler.h"
+#include "utils/types.h"
+
+namespace benchmarking {
+
+    /// Asymptotic complexity of benchmark in input size n
+    enum class Complexity {
+        kConstant,          ///< O(1)
+        kLinear,            ///< O(n)
+        kNLogN              ///< O(n log n)
+    };
+
+    /// Human-readable name of complexity
+    inline const char* ToString(Complexity complexity) noexcept {
+        switch (complexity) {
+            case Complexity::kConstant: return "O(1)";
+            case Complexity::kLinear: return "O(n)";
+            case Complexity::kNLogN: return "O(n log n)";
+        }
+        return "unknown";
+    }
+
+    namespace details {
+        /// Growth function of complexity
+        inline double ComplexityFunction(Complexity complexity, double n) noexcept {
+            switch (complexity) {
+                case Complexity::kConstant: return 1.0;
+                case Complexity::kLinear: return n;
+                case Complexity::kNLogN: return n * std::log2(std::max(n, 2.0));
+            }
+            return 1.0;
+        }
+    } // namespace details
+
+    /**
+     * @brief Geometric sweep of input sizes
+     * @param first First size (must be > 0)
+     * @param last Last size (inclusive)
+     * @param multiplier Ratio of consecutive sizes (must be > 1)
+     * @return Distinct sizes first, first * multiplier, ... <= last
+     */
+    inline std::vector<std::size_t> GeometricRange(std::size_t first, std::size_t last, double multiplier = 2.0) {
+        std::vector<std::size_t> sizes;
+        for (double size = static_cast<double>(std::max<std::size_t>(first, 1)); size <= static_cast<double>(last);
+             size *= std::max(multiplier, 1.01)) {
+            auto rounded = static_cast<std::size_t>(std::llround(size));
+            if (sizes.empty() || sizes.back() != rounded) {
+                sizes.push_back(rounded);
+            }
+        }
+        return sizes;
+    }
+
+    /**
+     * @brief Linear sweep of input sizes
+     * @param first First size
+     * @param last Last size (inclusive)
+     * @param step Difference of consecutive sizes (must be > 0)
+     * @return Sizes first, first + step, ... <= last
+     */
+    inline std::vector<std::size_t> LinearRange(std::size_t first, std::size_t last, std::size_t step) {
+        std::vector<std::size_t> sizes;
+        for (std::size_t size = first; size <= last; size += std::max<std::size_t>(step, 1)) {
+            sizes.push_back(size);
+        }
+        return sizes;
+    }
+
+    /// Measurement of one input size
+    class SizePoint {
+    public:
+        /// Input size n
+        std::size_t size_{0};
+
+        /// Working set in bytes (size_ * element bytes)
+        std::size_t working_set_bytes_{0};
+
+        /// Overhead-corrected time of one invocation (median if samples were recorded, else mean) in TSC ticks
+        TimePoint time_{0};
+
+        /// Time per element in TSC ticks
+        double per_element_{0.0};
+
+        /// Time per element converted with TSC calibration
+        std::chrono::duration<double, std::nano> per_element_ns_{0.0};
+
+        /// Smallest cache level working set fits into (0 - exceeds all caches)
+        int cache_level_{0};
+    };
+
+    /// Least-squares fit of time = coefficient_ * f(n)
+    class ComplexityFit {
+    public:
+        /// Fitted complexity
+        Complexity complexity_{Complexity::kConstant};
+
+        /// Coefficient of growth function in TSC ticks
+        double coefficient_{0.0};
+
+        /// Root mean square of relative residuals (lower is better)
+        double rms_{0.0};
+    };
+
+    /// Change of per-element cost where working set leaves cache level
+    class CacheInflection {
+    public:
+        /// Cache level that overflows
+        CacheLevel cache_{};
+
+        /// Last size whose working set fits into cache
+        std::size_t size_before_{0};
+
+        /// First size whose working set exceeds cache
+        std::size_t size_after_{0};
+
+        /// Per-element cost after boundary divided by cost before it
+        double cost_ratio_{1.0};
+
+        /// True if cost_ratio_ exceeds ComplexityResult::kInflectionRatio
+        bool significant_{false};
+    };
+
+    /// Result of size sweep
+    class ComplexityResult {
+    public:
+        /// Cost ratio across cache boundary reported as significant
+        static constexpr double kInflectionRatio = 1.25;
+
+        /// Measurement of every size in sweep order
+        std::vector<SizePoint> points_{};
+
+        /// Best fit (smallest rms_)
+        ComplexityFit fit_{};
+
+        /// Fits of all complexities in order of Complexity enumerators
+        std::array<ComplexityFit, 3> fits_{};
+
+        /// Cache boundaries crossed by sweep
+        std::vector<CacheInflection> inflections_{};
+    };
+
+    /**
+     * @brief Fit measured times to O(1), O(n) and O(n log n)
+     *
+     * Each model time = c * f(n) is fitted with weights 1/time^2, i.e. relative error is minimized,
+     * so large sizes do not dominate the fit.
+     *
+     * @param points Measured sizes
+     * @return Fits of all complexities
+     */
+    inline std::array<ComplexityFit, 3> FitComplexity(const std::vector<SizePoint>& points) {
+        std::array<ComplexityFit, 3> fits{};
+        for (std::size_t i = 0; i < fits.size(); ++i) {
+            ComplexityFit& fit = fits[i];
+            fit.complexity_ = static_cast<Complexity>(i);
+            double numerator = 0.0, denominator = 0.0;
+            std::size_t count = 0;
+            for (const SizePoint& point : points) {
+                if (point.time_ == 0) {
+                    continue;
+                }
+                const double time = static_cast<double>(point.time_);
+                const double growth = details::ComplexityFunction(fit.complexity_, static_cast<double>(point.size_));
+                numerator += growth / time;
+                denominator += growth * growth / (time * time);
+                ++count;
+            }
+            if (count == 0 || denominator == 0.0) {
+                fit.rms_ = std::numeric_limits<double>::infinity();
+                continue;
+            }
+            fit.coefficient_ = numerator / denominator;
+            double squares = 0.0;
+            for (const SizePoint& point : points) {
+                if (point.time_ == 0) {
+                    continue;
+                }
+                const double time = static_cast<double>(point.time_);
+                const double growth = details::ComplexityFunction(fit.complexity_, static_cast<double>(point.size_));
+                const double residual = (time - fit.coefficient_ * growth) / time;
+                squares += residual * residual;
+            }
+            fit.rms_ = std::sqrt(squares / static_cast<double>(count));
+        }
+        return fits;
+    }
+
+    /**
+     * @brief Benchmark code over sweep of input sizes
+     *
+     * Code is either invoked with size under measurement (`R(std::size_t)`, non-void result is sunk)
+     * or is a factory called once per size outside timed region that returns code to measure, e.g. with
+     * freshly built input:
+     * @code
+     * auto result = RunComplexity(benchmark, [](std::size_t n) {
+     *     return [data = std::vector<int>(n, 1)]() { return std::accumulate(data.begin(), data.end(), 0); };
+     * }, GeometricRange(1 << 8, 1 << 24), settings, sizeof(int));
+     * @endcode
+     *
+     * @tparam Benchmark TSCBenchmarking<...> (already initialized)
+     * @tparam Code Benchmark code or factory
+     * @param benchmark Benchmark instance
+     * @param code Benchmark code or factory of it
+     * @param sizes Input sizes in ascending order
+     * @param settings Settings of every Run()
+     * @param element_bytes Bytes of working set per element (maps sizes onto cache levels)
+     * @return Per-size measurements, complexity fit and cache inflection points
+     */
+    template<typename Benchmark, typename Code>
+    ComplexityResult RunComplexity(Benchmark& benchmark, Code&& code, const std::vector<std::size_t>& sizes,
+                                   typename Benchmark::Settings settings, std::size_t element_bytes) {
+        const std::vector<CacheLevel> caches = details::ReadCacheLevels();
+        const TSCCalibration& calibration = benchmark.GetCalibration();
+
+        ComplexityResult result{};
+        result.points_.reserve(sizes.size());
+        for (std::size_t size : sizes) {
+            typename Benchmark::Result run{};
+            using R = std::invoke_result_t<Code&, std::size_t>;
+            // add_lvalue_reference_t keeps void as is, so R& is never formed for void(std::size_t) code
+            if constexpr (std::is_void_v<R> || !std::is_invocable_v<std::add_lvalue_reference_t<R>>) {
+                run = benchmark.Run([&code, size]() FORCE_INLINE_LAMBDA { details::InvokeAndSink(code, size); }, settings);
+            } else {
+                auto sized_code = code(size);
+                run = benchmark.Run(sized_code, settings);
+            }
+
+            SizePoint point{};
+            point.size_ = size;
+            point.working_set_bytes_ = size * element_bytes;
+            point.time_ = settings.record_samples_ ? run.corrected_distribution_.median_ : run.corrected_time_;
+            point.per_element_ = static_cast<double>(point.time_) / static_cast<double>(std::max<std::size_t>(size, 1));
+            point.per_element_ns_ = calibration.ToFractionalNanos(point.per_element_);
+            for (const CacheLevel& cache : caches) {
+                if (point.working_set_bytes_ <= cache.size_bytes_) {
+                    point.cache_level_ = cache.level_;
+                    break;
+                }
+            }
+            result.points_.push_back(point);
+        }
+
+        result.fits_ = FitComplexity(result.points_);
+        result.fit_ = *std::min_element(result.fits_.begin(), result.fits_.end(),
+                                        [](const ComplexityFit& lhs, const ComplexityFit& rhs) { return lhs.rms_ < rhs.rms_; });
+
+        for (const CacheLevel& cache : caches) {
+            for (std::size_t i = 1; i < result.points_.size(); ++i) {
+                const SizePoint& before = result.points_[i - 1];
+                const SizePoint& after = result.points_[i];
+                if (before.working_set_bytes_ <= cache.size_bytes_ && after.working_set_bytes_ > cache.size_bytes_) {
+                    CacheInflection inflection{};
+                    inflection.cache_ = cache;
+                    inflection.size_before_ = before.size_;
+                    inflection.size_after_ = after.size_;
+                    if (before.per_element_ > 0.0) {
+                        inflection.cost_ratio_ = after.per_element_ / before.per_element_;
+                    }
+                    inflection.significant_ = inflection.cost_ratio_ > ComplexityResult::kInflectionRatio;
+                    result.inflections_.push_back(inflection);
+                    break;
+                }
+            }
+        }
+        return result;
+    }
+
+} // namespace benchmarking
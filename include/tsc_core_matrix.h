@@ -0,0 +1,177 @@
+#pragma once
+
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <vector>
+
+#include "tsc_calibration.h"
+#include "tsc_clock.h"
+#include "tsc_skew.h"
+#include "utils/types.h"
+
+namespace benchmarking {
+
+    /// Cache-line transfer latency between two cores (TSC ticks)
+    class CoreLatency {
+    public:
+        /// Minimal round trip
+        TimePoint min_round_trip_{0};
+
+        /// Median round trip
+        TimePoint median_round_trip_{0};
+
+        /// Minimal one-way latency (assumes synchronized TSCs)
+        std::int64_t min_one_way_{0};
+
+        /// Median one-way latency (assumes synchronized TSCs)
+        std::int64_t median_one_way_{0};
+
+        /// False if pair was not measured
+        bool valid_{false};
+    };
+
+    /**
+     * @brief NxN matrix of core-to-core cache-line transfer latency
+     *
+     * Every ordered pair (from, to) is measured with details::MeasurePingPong where `from` initiates.
+     * One-way latencies are raw responder minus initiator timestamps, so they are only meaningful
+     * on machines whose TSCs are synchronized (see TscSkewTable::IsSynchronized()).
+     *
+     * Example usage:
+     * @code
+     * auto matrix = CoreLatencyMatrix::Measure({0, 1, 2, 3});
+     * matrix.WriteCsv(std::cout, TSCCalibration::Calibrate());
+     * @endcode
+     */
+    class CoreLatencyMatrix {
+    public:
+        static constexpr std::size_t kDefaultRounds = 1000;
+
+        /**
+         * @brief Measure latency between all ordered pairs of CPUs
+         * @tparam BarrierType Barrier of initiator timestamps
+         * @param cpus CPU cores to include (must be distinct)
+         * @param rounds Ping-pong round trips per pair
+         * @return Latency matrix
+         */
+        template<Barrier BarrierType = Barrier::kRdtscp>
+        static CoreLatencyMatrix Measure(const std::vector<int>& cpus, std::size_t rounds = kDefaultRounds) {
+            CoreLatencyMatrix matrix{};
+            matrix.cpus_ = cpus;
+            const std::size_t n = cpus.size();
+            matrix.latencies_.assign(n * n, CoreLatency{});
+            for (std::size_t i = 0; i < n; ++i) {
+                matrix.latencies_[i * n + i].valid_ = true;
+                for (std::size_t j = 0; j < n; ++j) {
+                    if (i == j) {
+                        continue;
+                    }
+                    details::PingPongResult pair = details::MeasurePingPong<BarrierType>(cpus[i], cpus[j], rounds);
+                    CoreLatency& latency = matrix.latencies_[i * n + j];
+                    latency.valid_ = pair.valid_;
+                    latency.min_round_trip_ = pair.min_round_trip_;
+                    latency.median_round_trip_ = pair.median_round_trip_;
+                    latency.min_one_way_ = pair.min_one_way_;
+                    latency.median_one_way_ = pair.median_one_way_;
+                }
+            }
+            return matrix;
+        }
+
+        /// CPU cores covered by matrix
+        [[nodiscard]] const std::vector<int>& Cpus() const noexcept { return cpus_; }
+
+        /// Latency of pair by positions in Cpus()
+        [[nodiscard]] const CoreLatency& At(std::size_t from, std::size_t to) const noexcept {
+            return latencies_[from * cpus_.size() + to];
+        }
+
+        /// Write one row per ordered pair in nanoseconds
+        void WriteCsv(std::ostream& out, const TSCCalibration& calibration) const {
+            out << "from_cpu,to_cpu,min_round_trip_ns,median_round_trip_ns,min_one_way_ns,median_one_way_ns\n";
+            for (std::size_t i = 0; i < cpus_.size(); ++i) {
+                for (std::size_t j = 0; j < cpus_.size(); ++j) {
+                    const CoreLatency& latency = At(i, j);
+                    if (i == j || !latency.valid_) {
+                        continue;
+                    }
+                    out << cpus_[i] << ',' << cpus_[j] << ','
+                        << Nanos(calibration, static_cast<double>(latency.min_round_trip_)) << ','
+                        << Nanos(calibration, static_cast<double>(latency.median_round_trip_)) << ','
+                        << Nanos(calibration, static_cast<double>(latency.min_one_way_)) << ','
+                        << Nanos(calibration, static_cast<double>(latency.median_one_way_)) << '\n';
+                }
+            }
+        }
+
+        /// Write matrices of median round trip and one-way latency in nanoseconds
+        void WriteJson(std::ostream& out, const TSCCalibration& calibration) const {
+            out << "{\n  \"tsc_hz\": " << std::fixed << std::setprecision(0) << calibration.Frequency()
+                << std::defaultfloat << ",\n  \"cpus\": [";
+            for (std::size_t i = 0; i < cpus_.size(); ++i) {
+                out << (i ? ", " : "") << cpus_[i];
+            }
+            out << "],\n";
+            WriteJsonMatrix(out, "median_round_trip_ns", calibration, [](const CoreLatency& latency) {
+                return static_cast<double>(latency.median_round_trip_);
+            });
+            out << ",\n";
+            WriteJsonMatrix(out, "median_one_way_ns", calibration, [](const CoreLatency& latency) {
+                return static_cast<double>(latency.median_one_way_);
+            });
+            out << "\n}\n";
+        }
+
+        /// Write human-readable matrix of median round trip in nanoseconds
+        void WriteTable(std::ostream& out, const TSCCalibration& calibration) const {
+            out << "Median round trip, ns (row initiates)\n" << std::setw(6) << "";
+            for (int cpu : cpus_) {
+                out << ' ' << std::setw(9) << cpu;
+            }
+            out << '\n';
+            for (std::size_t i = 0; i < cpus_.size(); ++i) {
+                out << std::setw(6) << cpus_[i];
+                for (std::size_t j = 0; j < cpus_.size(); ++j) {
+                    const CoreLatency& latency = At(i, j);
+                    if (i == j || !latency.valid_) {
+                        out << ' ' << std::setw(9) << "-";
+                    } else {
+                        out << ' ' << std::setw(9) << std::fixed << std::setprecision(1)
+                            << Nanos(calibration, static_cast<double>(latency.median_round_trip_)) << std::defaultfloat;
+                    }
+                }
+                out << '\n';
+            }
+        }
+
+    private:
+        static double Nanos(const TSCCalibration& calibration, double ticks) noexcept {
+            return calibration.ToFractionalNanos(ticks).count();
+        }
+
+        template<typename Value>
+        void WriteJsonMatrix(std::ostream& out, const char* name, const TSCCalibration& calibration, Value&& value) const {
+            out << "  \"" << name << "\": [";
+            for (std::size_t i = 0; i < cpus_.size(); ++i) {
+                out << (i ? ",\n    [" : "\n    [");
+                for (std::size_t j = 0; j < cpus_.size(); ++j) {
+                    const CoreLatency& latency = At(i, j);
+                    out << (j ? ", " : "");
+                    if (i != j && !latency.valid_) {
+                        out << "null";
+                    } else {
+                        out << std::fixed << std::setprecision(1)
+                            << (i == j ? 0.0 : Nanos(calibration, value(latency))) << std::defaultfloat;
+                    }
+                }
+                out << ']';
+            }
+            out << "\n  ]";
+        }
+
+        std::vector<int> cpus_{};                   ///< Measured CPU cores
+        std::vector<CoreLatency> latencies_{};      ///< Row-major NxN latencies (row initiates)
+    };
+
+} // namespace benchmarking
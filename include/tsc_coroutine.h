@@ -0,0 +1,264 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "tsc_calibration.h"
+#include "tsc_cpu.h"
+#include "tsc_statistics.h"
+#include "utils/compiler.h"
+#include "utils/types.h"
+
+namespace benchmarking {
+
+    /// Suspend-to-resume intervals recorded by TimedAwaitable
+    class ResumeRecorder {
+    public:
+        /// Preallocate room for samples_number intervals
+        void Reserve(std::size_t samples_number) { samples_.reserve(samples_number); }
+
+        /// Record one interval in TSC ticks
+        FORCE_INLINE void Record(TimePoint ticks) { samples_.push_back(ticks); }
+
+        void Clear() noexcept { samples_.clear(); }
+
+        /// Recorded intervals in order of resumption
+        [[nodiscard]] std::vector<TimePoint>& Samples() noexcept { return samples_; }
+        [[nodiscard]] const std::vector<TimePoint>& Samples() const noexcept { return samples_; }
+
+    private:
+        std::vector<TimePoint> samples_{};
+    };
+
+    /**
+     * @brief Awaiter wrapper that stamps Rdtsc() when coroutine suspends and when it resumes
+     *
+     * Interval covers awaiter's await_suspend() (enqueue into scheduler), wait in scheduler and
+     * resumption - the hand-off cost of co_await. If awaiter completes without suspending, interval
+     * is the cost of ready path.
+     *
+     * @code
+     * co_await benchmarking::Timed(executor.Schedule(), recorder);
+     * @endcode
+     *
+     * @tparam Awaiter Awaiter type (await_ready/await_suspend/await_resume members)
+     */
+    template<typename Awaiter>
+    class TimedAwaitable {
+    public:
+        TimedAwaitable(Awaiter awaiter, ResumeRecorder& recorder) noexcept(std::is_nothrow_move_constructible_v<Awaiter>)
+                : awaiter_{std::move(awaiter)}, recorder_{&recorder} {}
+
+        FORCE_INLINE bool await_ready() {
+            suspended_ = details::Rdtsc();
+            return awaiter_.await_ready();
+        }
+
+        template<typename Promise>
+        FORCE_INLINE decltype(auto) await_suspend(std::coroutine_handle<Promise> handle) {
+            suspended_ = details::Rdtsc();
+            return awaiter_.await_suspend(handle);
+        }
+
+        FORCE_INLINE decltype(auto) await_resume() {
+            recorder_->Record(details::Rdtsc() - suspended_);
+            return awaiter_.await_resume();
+        }
+
+    private:
+        Awaiter awaiter_;
+        ResumeRecorder* recorder_;
+        TimePoint suspended_{0};
+    };
+
+    /// Wrap awaiter into TimedAwaitable
+    template<typename Awaiter>
+    TimedAwaitable<std::decay_t<Awaiter>> Timed(Awaiter&& awaiter, ResumeRecorder& recorder) {
+        return TimedAwaitable<std::decay_t<Awaiter>>{std::forward<Awaiter>(awaiter), recorder};
+    }
+
+    /**
+     * @brief Executor driven by MeasureCoroutineHops()
+     *
+     * Schedule() returns awaiter that hands coroutine to executor; Drain() runs queued coroutines
+     * on calling thread (or waits for worker threads) until no work is left.
+     */
+    template<typename Executor>
+    concept CoroutineExecutor = requires(Executor& executor) {
+        executor.Schedule();
+        executor.Drain();
+    };
+
+    /**
+     * @brief Single-threaded FIFO executor - reference scheduler and template for custom executors
+     */
+    class FifoExecutor {
+    public:
+        class ScheduleAwaiter {
+        public:
+            explicit ScheduleAwaiter(FifoExecutor& executor) noexcept : executor_{&executor} {}
+
+            [[nodiscard]] bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) { executor_->queue_.push_back(handle); }
+            void await_resume() const noexcept {}
+
+        private:
+            FifoExecutor* executor_;
+        };
+
+        /// Awaiter that enqueues coroutine
+        [[nodiscard]] ScheduleAwaiter Schedule() noexcept { return ScheduleAwaiter{*this}; }
+
+        /// Resume queued coroutines (including ones they schedule) until queue is empty
+        void Drain() {
+            while (!queue_.empty()) {
+                std::coroutine_handle<> handle = queue_.front();
+                queue_.pop_front();
+                handle.resume();
+            }
+        }
+
+    private:
+        std::deque<std::coroutine_handle<>> queue_{};
+    };
+
+    /**
+     * @brief Resume latency of coroutine hops through executor
+     */
+    class CoroutineResult {
+    public:
+        using FractionalNanos = std::chrono::duration<double, std::nano>;
+
+        /// Number of recorded hops
+        std::size_t hops_number_{0};
+
+        /// Suspend-to-resume interval of every hop in TSC ticks
+        Distribution resume_{};
+
+        /// Resume interval with timing overhead subtracted (clamped at 0)
+        Distribution corrected_resume_{};
+
+        /// Minimal cost of TimedAwaitable itself (ready path of no-op awaiter) in TSC ticks
+        TimePoint overhead_{0};
+
+        /// Wall time per hop including loop and scheduling in TSC ticks
+        double hop_time_{0.0};
+        FractionalNanos hop_time_ns_{0.0};
+
+        /// Corrected median resume latency
+        FractionalNanos median_resume_ns_{0.0};
+    };
+
+    namespace details {
+        /// Coroutine owned by harness: starts suspended, stays suspended at end for destruction
+        class HarnessTask {
+        public:
+            class promise_type {
+            public:
+                HarnessTask get_return_object() noexcept {
+                    return HarnessTask{std::coroutine_handle<promise_type>::from_promise(*this)};
+                }
+                std::suspend_always initial_suspend() const noexcept { return {}; }
+                std::suspend_always final_suspend() const noexcept { return {}; }
+                void return_void() const noexcept {}
+                void unhandled_exception() const noexcept { std::terminate(); }
+            };
+
+            explicit HarnessTask(std::coroutine_handle<promise_type> handle) noexcept : handle_{handle} {}
+            HarnessTask(const HarnessTask&) = delete;
+            HarnessTask& operator=(const HarnessTask&) = delete;
+            HarnessTask(HarnessTask&& other) noexcept : handle_{std::exchange(other.handle_, {})} {}
+            HarnessTask& operator=(HarnessTask&&) = delete;
+
+            ~HarnessTask() {
+                if (handle_) {
+                    handle_.destroy();
+                }
+            }
+
+            [[nodiscard]] std::coroutine_handle<promise_type> Handle() const noexcept { return handle_; }
+
+        private:
+            std::coroutine_handle<promise_type> handle_;
+        };
+
+        template<typename Executor>
+        HarnessTask TimedHops(Executor& executor, std::size_t hops, ResumeRecorder& recorder) {
+            for (std::size_t i = 0; i < hops; ++i) {
+                co_await Timed(executor.Schedule(), recorder);
+            }
+        }
+
+        /// Minimal cost of TimedAwaitable around awaiter that never suspends
+        inline TimePoint MeasureTimedOverhead(std::size_t samples_number) {
+            ResumeRecorder recorder{};
+            recorder.Reserve(samples_number);
+            auto task = [](std::size_t count, ResumeRecorder& samples) -> HarnessTask {
+                for (std::size_t i = 0; i < count; ++i) {
+                    co_await Timed(std::suspend_never{}, samples);
+                }
+            }(samples_number, recorder);
+            task.Handle().resume();
+            const std::vector<TimePoint>& samples = recorder.Samples();
+            return samples.empty() ? 0 : *std::min_element(samples.begin(), samples.end());
+        }
+    } // namespace details
+
+    /**
+     * @brief Drive coroutine that hops through executor and measure resume latency of every hop
+     *
+     * Coroutine is started on calling thread, each hop co_awaits Timed(executor.Schedule()),
+     * and executor.Drain() is called until coroutine finishes. Call on pinned thread; executors
+     * resuming on other cores rely on invariant, synchronized TSC.
+     *
+     * @param executor Executor (Schedule() awaiter and Drain())
+     * @param hops Number of measured hops
+     * @param calibration TSC calibration for nanosecond fields
+     * @param warmup_hops Hops run before measurement
+     * @return Resume latency distribution and per-hop cost
+     */
+    template<CoroutineExecutor Executor>
+    CoroutineResult MeasureCoroutineHops(Executor& executor, std::size_t hops, const TSCCalibration& calibration,
+                                         std::size_t warmup_hops = 100) {
+        ResumeRecorder recorder{};
+        recorder.Reserve(std::max(hops, warmup_hops));
+        auto run = [&executor, &recorder](std::size_t count) {
+            details::HarnessTask task = details::TimedHops(executor, count, recorder);
+            task.Handle().resume();
+            while (!task.Handle().done()) {
+                executor.Drain();
+            }
+        };
+        run(warmup_hops);
+        recorder.Clear();
+
+        CoroutineResult result{};
+        result.overhead_ = details::MeasureTimedOverhead(1000);
+        const TimePoint begin = details::Rdtsc();
+        run(hops);
+        const TimePoint end = details::Rdtsc();
+
+        std::vector<TimePoint>& samples = recorder.Samples();
+        result.hops_number_ = samples.size();
+        if (samples.empty()) {
+            return result;
+        }
+        result.hop_time_ = static_cast<double>(end - begin) / static_cast<double>(samples.size());
+        result.hop_time_ns_ = calibration.ToFractionalNanos(result.hop_time_);
+        result.resume_ = ComputeDistribution(samples);
+        for (TimePoint& sample : samples) {
+            sample = sample > result.overhead_ ? sample - result.overhead_ : 0;
+        }
+        result.corrected_resume_ = ComputeDistribution(samples);
+        result.median_resume_ns_ = calibration.ToFractionalNanos(static_cast<double>(result.corrected_resume_.median_));
+        return result;
+    }
+
+} // namespace benchmarking
@@ -1,5 +1,15 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <sched.h>
+
+#include "utils/affinity.h"
 #include "utils/compiler.h"
 #include "utils/types.h"
 
@@ -56,6 +66,46 @@ namespace benchmarking::details {
         __asm__ __volatile__("cpuid" :: "a"(0) : "rbx", "rcx", "rdx");
     }
 
+    /// Output registers of a single CPUID query
+    struct CpuIdRegisters {
+        InternalRegister eax_{0};
+        InternalRegister ebx_{0};
+        InternalRegister ecx_{0};
+        InternalRegister edx_{0};
+    };
+
+    /// Execute CPUID for a specific leaf/subleaf and return all output registers
+    /// @param leaf Value loaded into EAX
+    /// @param subleaf Value loaded into ECX
+    /// @return Registers EAX..EDX after CPUID
+    inline CpuIdRegisters QueryCpuId(InternalRegister leaf, InternalRegister subleaf = 0) noexcept {
+        CpuIdRegisters regs{};
+        __asm__ __volatile__("cpuid"
+                            : "=a"(regs.eax_), "=b"(regs.ebx_), "=c"(regs.ecx_), "=d"(regs.edx_)
+                            : "a"(leaf), "c"(subleaf));
+        return regs;
+    }
+
+    /// Processor brand string from CPUID leaves 0x80000002..0x80000004
+    /// @return Brand string without surrounding spaces (empty if leaves are not supported)
+    inline std::string CpuBrandString() {
+        if (QueryCpuId(0x80000000).eax_ < 0x80000004) {
+            return {};
+        }
+        char brand[49]{};
+        for (InternalRegister i = 0; i < 3; ++i) {
+            CpuIdRegisters regs = QueryCpuId(0x80000002 + i);
+            std::memcpy(brand + i * 16, &regs.eax_, 4);
+            std::memcpy(brand + i * 16 + 4, &regs.ebx_, 4);
+            std::memcpy(brand + i * 16 + 8, &regs.ecx_, 4);
+            std::memcpy(brand + i * 16 + 12, &regs.edx_, 4);
+        }
+        std::string result{brand};
+        result.erase(0, result.find_first_not_of(' '));
+        result.erase(result.find_last_not_of(' ') + 1);
+        return result;
+    }
+
     /// Load fence - orders loads
     FORCE_INLINE void LFence() noexcept {
         __asm__ __volatile__("lfence" ::: "memory");
@@ -66,23 +116,156 @@ namespace benchmarking::details {
         __asm__ __volatile__("mfence" ::: "memory");
     }
 
-    /// CPU information and capability detection
+    /// Cache described by CPUID leaf 4 (Intel) or 0x8000001D (AMD)
+    class CpuCache {
+    public:
+        /// Cache level (1 - L1, 2 - L2, ...)
+        int level_{0};
+
+        /// Cache type (1 - data, 2 - instruction, 3 - unified)
+        int type_{0};
+
+        /// Size in bytes (ways * partitions * line size * sets)
+        std::size_t size_bytes_{0};
+
+        /// Line size in bytes
+        std::size_t line_bytes_{0};
+
+        /// Associativity
+        std::size_t ways_{0};
+
+        /// Maximal number of logical processors sharing cache
+        std::size_t sharing_{0};
+    };
+
+    /// Placement of one logical CPU derived from its (x2)APIC id
+    class CpuTopology {
+    public:
+        /// Logical CPU number used by scheduler
+        int cpu_{0};
+
+        /// x2APIC id (leaf 0x1F/0xB EDX) or initial APIC id (leaf 1 EBX[31:24])
+        InternalRegister apic_id_{0};
+
+        /// Package (socket) id
+        InternalRegister package_{0};
+
+        /// Core id within package
+        InternalRegister core_{0};
+
+        /// SMT thread id within core
+        InternalRegister thread_{0};
+
+        /// Hybrid core type (leaf 0x1A EAX[31:24]: 0x20 - Atom, 0x40 - Core, 0 - not hybrid)
+        std::uint8_t core_type_{0};
+    };
+
+    /**
+     * @brief CPU information and capability detection
+     *
+     * CPUID is serializing and slow in virtual machines, so Instance() parses all leaves once
+     * per process. Leaf values that differ between logical CPUs (APIC id, hybrid core type) are
+     * collected by GetCpuTopology().
+     */
     class CpuInfo {
     private:
         using InternalReg = InternalRegister;
 
         // CPUID feature bit positions
-        static constexpr InternalReg kTscFeatureBit = 1u << 4;      // TSC support
-        static constexpr InternalReg kRdtscpFeatureBit = 1u << 27;  // RDTSCP support  
-        static constexpr InternalReg kInvariantTscBit = 1u << 8;    // Invariant TSC
+        static constexpr InternalReg kTscFeatureBit = 1u << 4;          // Leaf 1 EDX - TSC support
+        static constexpr InternalReg kRdtscpFeatureBit = 1u << 27;      // Leaf 0x80000001 EDX - RDTSCP support
+        static constexpr InternalReg kInvariantTscBit = 1u << 8;        // Leaf 0x80000007 EDX - Invariant TSC
+        static constexpr InternalReg kHybridBit = 1u << 15;             // Leaf 7 EDX - hybrid part
+        static constexpr InternalReg kTopologyExtensionsBit = 1u << 22; // Leaf 0x80000001 ECX - AMD leaf 0x8000001D
+        static constexpr InternalReg kHypervisorBit = 1u << 31;         // Leaf 1 ECX - running under hypervisor
+        static constexpr InternalReg kLFenceSerializingBit = 1u << 2;   // Leaf 0x80000021 EAX - AMD LFENCE always serializing
+        static constexpr InternalReg kKvmStableClockBit = 1u << 24;     // Leaf 0x40000001 EAX - KVM_FEATURE_CLOCKSOURCE_STABLE_BIT
 
     public:
         CpuInfo() {
-            // Execute CPUID with EAX=1
-            __asm__ __volatile__("cpuid" 
-                                : "=a"(registers_[0]), "=b"(registers_[1]), 
-                                  "=c"(registers_[2]), "=d"(registers_[3])
-                                : "a"(1), "c"(0));
+            CpuIdRegisters vendor = QueryCpuId(0);
+            max_leaf_ = vendor.eax_;
+            char name[13]{};
+            std::memcpy(name, &vendor.ebx_, 4);
+            std::memcpy(name + 4, &vendor.edx_, 4);
+            std::memcpy(name + 8, &vendor.ecx_, 4);
+            vendor_ = name;
+            max_extended_leaf_ = QueryCpuId(0x80000000).eax_;
+
+            CpuIdRegisters features = QueryCpuId(1);
+            tsc_ = (features.edx_ & kTscFeatureBit) != 0;
+            hypervisor_ = (features.ecx_ & kHypervisorBit) != 0;
+            if (hypervisor_) {
+                // Leaves 0x40000000+ are defined only under hypervisor (bare metal returns unrelated data)
+                CpuIdRegisters hypervisor = QueryCpuId(0x40000000);
+                hypervisor_max_leaf_ = hypervisor.eax_;
+                char hypervisor_name[13]{};
+                std::memcpy(hypervisor_name, &hypervisor.ebx_, 4);
+                std::memcpy(hypervisor_name + 4, &hypervisor.ecx_, 4);
+                std::memcpy(hypervisor_name + 8, &hypervisor.edx_, 4);
+                hypervisor_vendor_ = hypervisor_name;
+                if (hypervisor_vendor_ == "KVMKVMKVM" && hypervisor_max_leaf_ >= 0x40000001) {
+                    kvm_features_ = QueryCpuId(0x40000001).eax_;
+                }
+                // Generic timing leaf (VMware, KVM with tsc-frequency exposed): EAX - TSC frequency in kHz
+                if (hypervisor_max_leaf_ >= 0x40000010) {
+                    hypervisor_tsc_khz_ = QueryCpuId(0x40000010).eax_;
+                }
+            }
+            if (max_leaf_ >= 7) {
+                hybrid_ = (QueryCpuId(7).edx_ & kHybridBit) != 0;
+            }
+
+            InternalReg extended_ecx = 0;
+            if (max_extended_leaf_ >= 0x80000001) {
+                CpuIdRegisters extended = QueryCpuId(0x80000001);
+                rdtscp_ = (extended.edx_ & kRdtscpFeatureBit) != 0;
+                extended_ecx = extended.ecx_;
+            }
+            if (max_extended_leaf_ >= 0x80000007) {
+                invariant_tsc_ = (QueryCpuId(0x80000007).edx_ & kInvariantTscBit) != 0;
+            }
+
+            // LFENCE is dispatch serializing on Intel; AMD guarantees it only if leaf 0x80000021 says so
+            // (otherwise it depends on MSR C001_1029, which user space cannot read)
+            if (vendor_ == "GenuineIntel") {
+                lfence_serializing_ = true;
+            } else if (max_extended_leaf_ >= 0x80000021) {
+                lfence_serializing_ = (QueryCpuId(0x80000021).eax_ & kLFenceSerializingBit) != 0;
+            }
+
+            if (max_leaf_ >= 0x15) {
+                CpuIdRegisters ratio = QueryCpuId(0x15);
+                tsc_ratio_denominator_ = ratio.eax_;
+                tsc_ratio_numerator_ = ratio.ebx_;
+                crystal_hz_ = ratio.ecx_;
+            }
+
+            // Intel leaf 4 and AMD leaf 0x8000001D share register layout
+            InternalReg cache_leaf = 0;
+            if (vendor_ == "AuthenticAMD") {
+                if ((extended_ecx & kTopologyExtensionsBit) != 0 && max_extended_leaf_ >= 0x8000001D) {
+                    cache_leaf = 0x8000001D;
+                }
+            } else if (max_leaf_ >= 4) {
+                cache_leaf = 4;
+            }
+            for (InternalReg index = 0; cache_leaf != 0 && index < kMaxCacheLeaves; ++index) {
+                CpuIdRegisters regs = QueryCpuId(cache_leaf, index);
+                CpuCache cache{};
+                cache.type_ = static_cast<int>(regs.eax_ & 0x1F);
+                if (cache.type_ == 0) {
+                    break;
+                }
+                cache.level_ = static_cast<int>((regs.eax_ >> 5) & 0x7);
+                cache.sharing_ = ((regs.eax_ >> 14) & 0xFFF) + 1;
+                cache.line_bytes_ = (regs.ebx_ & 0xFFF) + 1;
+                cache.ways_ = ((regs.ebx_ >> 22) & 0x3FF) + 1;
+                const std::size_t partitions = ((regs.ebx_ >> 12) & 0x3FF) + 1;
+                const std::size_t sets = static_cast<std::size_t>(regs.ecx_) + 1;
+                cache.size_bytes_ = cache.ways_ * partitions * cache.line_bytes_ * sets;
+                caches_.push_back(cache);
+            }
         }
 
         CpuInfo(const CpuInfo&) = default;
@@ -91,29 +274,175 @@ namespace benchmarking::details {
         CpuInfo& operator=(CpuInfo&&) = default;
         ~CpuInfo() = default;
 
-        /// Check if TSC (Time Stamp Counter) is supported
-        [[nodiscard]] bool IsTscEnabled() const noexcept {
-            return IsFeatureEnabled(GetEdx(), kTscFeatureBit);
+        /// CPU information of this process (CPUID runs once)
+        static const CpuInfo& Instance() {
+            static const CpuInfo info{};
+            return info;
         }
 
+        /// Check if TSC (Time Stamp Counter) is supported
+        [[nodiscard]] bool IsTscEnabled() const noexcept { return tsc_; }
+
         /// Check if Invariant TSC is supported
-        [[nodiscard]] bool IsInvariantTscEnabled() const noexcept {
-            return IsFeatureEnabled(GetEdx(), kInvariantTscBit);
-        }
+        [[nodiscard]] bool IsInvariantTscEnabled() const noexcept { return invariant_tsc_; }
 
         /// Check if RDTSCP instruction is supported
-        [[nodiscard]] bool IsRdtscpEnabled() const noexcept {
-            return IsFeatureEnabled(GetEdx(), kRdtscpFeatureBit);
+        [[nodiscard]] bool IsRdtscpEnabled() const noexcept { return rdtscp_; }
+
+        /// Check if CPU mixes core types (Intel hybrid, leaf 7 EDX bit 15)
+        [[nodiscard]] bool IsHybrid() const noexcept { return hybrid_; }
+
+        /// Check if running under hypervisor (leaf 1 ECX bit 31) - CPUID traps to VMM there
+        [[nodiscard]] bool IsHypervisorPresent() const noexcept { return hypervisor_; }
+
+        /// Hypervisor vendor from leaf 0x40000000 ("KVMKVMKVM", "Microsoft Hv", "VMwareVMware", ...; empty on bare metal)
+        [[nodiscard]] const std::string& HypervisorVendor() const noexcept { return hypervisor_vendor_; }
+
+        /// Highest hypervisor CPUID leaf (0 on bare metal)
+        [[nodiscard]] InternalReg HypervisorMaxLeaf() const noexcept { return hypervisor_max_leaf_; }
+
+        /// Check if KVM guarantees stable (monotonic, synchronized) paravirtual clock (leaf 0x40000001 EAX bit 24)
+        [[nodiscard]] bool IsKvmClockStable() const noexcept { return (kvm_features_ & kKvmStableClockBit) != 0; }
+
+        /// TSC frequency reported by hypervisor timing leaf 0x40000010 in Hz (0 if not reported)
+        [[nodiscard]] double HypervisorTscHz() const noexcept { return static_cast<double>(hypervisor_tsc_khz_) * 1e3; }
+
+        /// Check if LFENCE is guaranteed to be dispatch serializing (Intel, AMD leaf 0x80000021 EAX bit 2)
+        [[nodiscard]] bool IsLFenceSerializing() const noexcept { return lfence_serializing_; }
+
+        /// Vendor string ("GenuineIntel", "AuthenticAMD", ...)
+        [[nodiscard]] const std::string& Vendor() const noexcept { return vendor_; }
+
+        /// Highest standard and extended CPUID leaves
+        [[nodiscard]] InternalReg MaxLeaf() const noexcept { return max_leaf_; }
+        [[nodiscard]] InternalReg MaxExtendedLeaf() const noexcept { return max_extended_leaf_; }
+
+        /// TSC/crystal clock ratio from leaf 0x15 (0 if not enumerated)
+        [[nodiscard]] InternalReg TscRatioNumerator() const noexcept { return tsc_ratio_numerator_; }
+        [[nodiscard]] InternalReg TscRatioDenominator() const noexcept { return tsc_ratio_denominator_; }
+
+        /// Crystal clock frequency in Hz from leaf 0x15 (0 if not enumerated)
+        [[nodiscard]] InternalReg CrystalHz() const noexcept { return crystal_hz_; }
+
+        /// TSC frequency from leaf 0x15 in Hz (0 if ratio or crystal frequency is not enumerated)
+        [[nodiscard]] double TscHz() const noexcept {
+            if (tsc_ratio_denominator_ == 0 || tsc_ratio_numerator_ == 0 || crystal_hz_ == 0) {
+                return 0.0;
+            }
+            return static_cast<double>(crystal_hz_) * tsc_ratio_numerator_ / tsc_ratio_denominator_;
         }
 
+        /// Cache hierarchy in enumeration order (empty if leaf 4/0x8000001D is not available)
+        [[nodiscard]] const std::vector<CpuCache>& Caches() const noexcept { return caches_; }
+
     private:
-        [[nodiscard]] bool IsFeatureEnabled(InternalReg reg, InternalReg mask) const noexcept {
-            return (reg & mask) != 0;
+        static constexpr InternalReg kMaxCacheLeaves = 16;
+
+        std::string vendor_{};
+        InternalReg max_leaf_{0};
+        InternalReg max_extended_leaf_{0};
+        bool tsc_{false};
+        bool rdtscp_{false};
+        bool invariant_tsc_{false};
+        bool hybrid_{false};
+        bool hypervisor_{false};
+        bool lfence_serializing_{false};
+        std::string hypervisor_vendor_{};
+        InternalReg hypervisor_max_leaf_{0};
+        InternalReg kvm_features_{0};
+        InternalReg hypervisor_tsc_khz_{0};
+        InternalReg tsc_ratio_numerator_{0};
+        InternalReg tsc_ratio_denominator_{0};
+        InternalReg crystal_hz_{0};
+        std::vector<CpuCache> caches_{};
+    };
+
+    /// Query topology of CPU current thread runs on
+    inline CpuTopology QueryCurrentCpuTopology() noexcept {
+        const CpuInfo& info = CpuInfo::Instance();
+        CpuTopology topology{};
+        topology.apic_id_ = QueryCpuId(1).ebx_ >> 24;
+        topology.core_ = topology.apic_id_;
+
+        // Leaf 0x1F supersedes 0xB; subleaf level types: 1 - SMT, 2 - core, 3+ - module/tile/die
+        const InternalRegister leaf = info.MaxLeaf() >= 0x1F && QueryCpuId(0x1F).ebx_ != 0 ? 0x1F
+                                      : info.MaxLeaf() >= 0xB && QueryCpuId(0xB).ebx_ != 0 ? 0xB : 0;
+        if (leaf != 0) {
+            InternalRegister smt_shift = 0, package_shift = 0;
+            for (InternalRegister subleaf = 0; subleaf < 8; ++subleaf) {
+                CpuIdRegisters regs = QueryCpuId(leaf, subleaf);
+                const InternalRegister type = (regs.ecx_ >> 8) & 0xFF;
+                if (type == 0) {
+                    break;
+                }
+                if (type == 1) {
+                    smt_shift = regs.eax_ & 0x1F;
+                }
+                package_shift = regs.eax_ & 0x1F;
+                topology.apic_id_ = regs.edx_;
+            }
+            const std::uint64_t apic_id = topology.apic_id_;
+            const InternalRegister core_bits = package_shift > smt_shift ? package_shift - smt_shift : 0;
+            topology.thread_ = static_cast<InternalRegister>(apic_id & ((std::uint64_t{1} << smt_shift) - 1));
+            topology.core_ = static_cast<InternalRegister>((apic_id >> smt_shift) & ((std::uint64_t{1} << core_bits) - 1));
+            topology.package_ = static_cast<InternalRegister>(apic_id >> package_shift);
         }
+        if (info.IsHybrid() && info.MaxLeaf() >= 0x1A) {
+            topology.core_type_ = static_cast<std::uint8_t>(QueryCpuId(0x1A).eax_ >> 24);
+        }
+        return topology;
+    }
 
-        [[nodiscard]] const InternalReg& GetEdx() const noexcept { return registers_[3]; }
+    /**
+     * @brief Topology of every online CPU (collected once per process)
+     *
+     * Calling thread is moved to every CPU in turn to read its APIC id; its affinity mask is
+     * restored afterwards. CPUs that cannot be entered (offline, outside cpuset) are skipped.
+     */
+    inline const std::vector<CpuTopology>& GetCpuTopology() {
+        static const std::vector<CpuTopology> topology = []() {
+            std::vector<CpuTopology> cpus;
+            cpu_set_t original;
+            CPU_ZERO(&original);
+            const bool restore = sched_getaffinity(0, sizeof(original), &original) == 0;
+            for (int cpu : GetCpuList()) {
+                if (!PinThread(cpu, false)) {
+                    continue;
+                }
+                CpuTopology entry = QueryCurrentCpuTopology();
+                entry.cpu_ = cpu;
+                cpus.push_back(entry);
+            }
+            if (restore) {
+                sched_setaffinity(0, sizeof(original), &original);
+            }
+            return cpus;
+        }();
+        return topology;
+    }
 
-        InternalReg registers_[4]{};
-    };
+    /**
+     * @brief CPUs ordered for thread placement
+     *
+     * First SMT thread of every physical core comes first (packages interleaved by core), then
+     * remaining SMT siblings, so the first N workers never share a core while N <= cores.
+     *
+     * @return CPU numbers (GetCpuList() if topology is not available)
+     */
+    inline std::vector<int> GetPlacementCpuList() {
+        std::vector<CpuTopology> topology = GetCpuTopology();
+        if (topology.empty()) {
+            return GetCpuList();
+        }
+        std::stable_sort(topology.begin(), topology.end(), [](const CpuTopology& lhs, const CpuTopology& rhs) {
+            return std::tie(lhs.thread_, lhs.core_, lhs.package_) < std::tie(rhs.thread_, rhs.core_, rhs.package_);
+        });
+        std::vector<int> cpus;
+        cpus.reserve(topology.size());
+        for (const CpuTopology& entry : topology) {
+            cpus.push_back(entry.cpu_);
+        }
+        return cpus;
+    }
 
 } // namespace benchmarking::details
@@ -0,0 +1,261 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "tsc_cpu.h"
+#include "utils/compiler.h"
+#include "utils/types.h"
+
+namespace benchmarking {
+
+    /// Gaps in TSC progression observed while spinning on Rdtsc() (interrupts, SMIs, preemption)
+    class GapStatistics {
+    public:
+        /// Spin duration in TSC ticks
+        TimePoint spin_ticks_{0};
+
+        /// Number of consecutive reads further apart than threshold
+        std::size_t gaps_number_{0};
+
+        /// Sum of all gaps in TSC ticks
+        TimePoint gap_ticks_{0};
+
+        /// Longest gap in TSC ticks
+        TimePoint max_gap_{0};
+
+        /// Fraction of spin time lost in gaps (0 - quiet core, 1 - no progress)
+        [[nodiscard]] double StolenFraction() const noexcept {
+            return spin_ticks_ == 0 ? 0.0 : static_cast<double>(gap_ticks_) / static_cast<double>(spin_ticks_);
+        }
+
+        /// Accumulate statistics of another probe
+        GapStatistics& operator+=(const GapStatistics& other) noexcept {
+            spin_ticks_ += other.spin_ticks_;
+            gaps_number_ += other.gaps_number_;
+            gap_ticks_ += other.gap_ticks_;
+            max_gap_ = std::max(max_gap_, other.max_gap_);
+            return *this;
+        }
+    };
+
+    namespace details {
+        /// Read first line of sysfs/procfs file (empty if file is missing)
+        inline std::string ReadFirstLine(const std::string& path) {
+            std::ifstream file{path};
+            std::string line;
+            std::getline(file, line);
+            return line;
+        }
+
+        /// Parse CPU list in kernel format ("0-3,8,10-11")
+        inline std::vector<int> ParseCpuList(const std::string& list) {
+            std::vector<int> cpus;
+            std::stringstream stream{list};
+            for (std::string range; std::getline(stream, range, ',');) {
+                if (range.empty() || range.find_first_of("0123456789") == std::string::npos) {
+                    continue;
+                }
+                std::size_t dash = range.find('-');
+                int first = std::stoi(range.substr(0, dash));
+                int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+                for (int cpu = first; cpu <= last; ++cpu) {
+                    cpus.push_back(cpu);
+                }
+            }
+            return cpus;
+        }
+
+        /// Check if CPU list file contains cpu
+        inline bool CpuListContains(const std::string& path, int cpu) {
+            std::vector<int> cpus = ParseCpuList(ReadFirstLine(path));
+            return std::find(cpus.begin(), cpus.end(), cpu) != cpus.end();
+        }
+
+        /**
+         * @brief Spin on Rdtsc() and record jumps between consecutive reads
+         * @param duration Spin duration in TSC ticks
+         * @param threshold Jump reported as gap in TSC ticks
+         * @return Gap statistics
+         */
+        inline GapStatistics DetectGaps(TimePoint duration, TimePoint threshold) noexcept {
+            GapStatistics gaps{};
+            const TimePoint begin = Rdtsc();
+            const TimePoint deadline = begin + duration;
+            TimePoint previous = begin;
+            while (previous < deadline) {
+                const TimePoint now = Rdtsc();
+                const TimePoint delta = now - previous;
+                if (UNLIKELY(delta > threshold)) {
+                    ++gaps.gaps_number_;
+                    gaps.gap_ticks_ += delta;
+                    gaps.max_gap_ = std::max(gaps.max_gap_, delta);
+                }
+                previous = now;
+            }
+            gaps.spin_ticks_ = previous - begin;
+            return gaps;
+        }
+    } // namespace details
+
+    /**
+     * @brief Pre-flight check of system configuration affecting benchmark CPU
+     *
+     * Every setting that is known to add noise produces one entry in warnings_; settings that
+     * cannot be read (missing sysfs files, containers) are left empty and do not warn.
+     */
+    class EnvironmentReport {
+    public:
+        /// CPU core checked
+        int cpu_{0};
+
+        /// cpufreq scaling governor of cpu_ (empty if cpufreq is not available)
+        std::string governor_{};
+
+        /// Turbo/boost state (intel_pstate/no_turbo or cpufreq/boost), empty if unknown
+        std::optional<bool> turbo_enabled_{};
+
+        /// cpu_ is listed in isolcpus
+        bool isolated_{false};
+
+        /// cpu_ is listed in nohz_full
+        bool nohz_full_{false};
+
+        /// Online SMT siblings of cpu_ (excluding cpu_ itself)
+        std::vector<int> smt_siblings_{};
+
+        /// Number of IRQs whose affinity includes cpu_
+        std::size_t irqs_number_{0};
+
+        /// Hypervisor vendor (empty on bare metal)
+        std::string hypervisor_{};
+
+        /// Current kernel clocksource ("tsc", "kvm-clock", "hpet", ...; empty if unknown)
+        std::string clocksource_{};
+
+        /// RDTSC is safe for benchmarking: invariant, and kernel uses it or hypervisor guarantees stable clock
+        bool tsc_reliable_{false};
+
+        /// Human-readable description of every noise source found
+        std::vector<std::string> warnings_{};
+
+        /// True if no noise source was found
+        [[nodiscard]] bool IsClean() const noexcept { return warnings_.empty(); }
+
+        /// Print one [Warning] line per noise source
+        void Print(std::ostream& out) const {
+            for (const std::string& warning : warnings_) {
+                out << "[Warning] " << warning << std::endl;
+            }
+        }
+    };
+
+    namespace details {
+        /**
+         * @brief Check if RDTSC gives valid intervals on this host
+         *
+         * Bare metal needs invariant TSC only. In a guest RDTSC may be offset per vCPU, scaled or
+         * trapped; it is trusted if the kernel kept "tsc" as clocksource (it verified TSC stability)
+         * or KVM advertises stable paravirtual clock.
+         */
+        inline bool IsTscReliable(const std::string& clocksource) noexcept {
+            const CpuInfo& info = CpuInfo::Instance();
+            if (!info.IsTscEnabled() || !info.IsInvariantTscEnabled()) {
+                return false;
+            }
+            return !info.IsHypervisorPresent() || clocksource == "tsc" || info.IsKvmClockStable();
+        }
+    } // namespace details
+
+    /**
+     * @brief Inspect governor, turbo, isolation, SMT siblings, IRQ affinity and clock source of CPU core
+     * @param cpu CPU core benchmark is pinned to
+     * @param tsc_clock Benchmark reads TSC directly (warn if TSC is not reliable on this host)
+     * @return Report with one warning per noise source
+     */
+    inline EnvironmentReport CheckEnvironment(int cpu, bool tsc_clock = true) {
+        EnvironmentReport report{};
+        report.cpu_ = cpu;
+        const std::string cpu_path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/";
+
+        const details::CpuInfo& info = details::CpuInfo::Instance();
+        report.hypervisor_ = info.IsHypervisorPresent()
+                             ? (info.HypervisorVendor().empty() ? std::string{"unknown"} : info.HypervisorVendor())
+                             : std::string{};
+        report.clocksource_ = details::ReadFirstLine("/sys/devices/system/clocksource/clocksource0/current_clocksource");
+        report.tsc_reliable_ = details::IsTscReliable(report.clocksource_);
+        if (tsc_clock && !report.tsc_reliable_) {
+            report.warnings_.push_back("TSC is not reliable" +
+                                       (report.hypervisor_.empty() ? std::string{} : " under " + report.hypervisor_ + " hypervisor") +
+                                       " (clocksource '" + report.clocksource_ + "') - use VdsoClock");
+        }
+
+        report.governor_ = details::ReadFirstLine(cpu_path + "cpufreq/scaling_governor");
+        if (!report.governor_.empty() && report.governor_ != "performance") {
+            report.warnings_.push_back("CPU " + std::to_string(cpu) + " uses '" + report.governor_ +
+                                       "' frequency governor (use 'performance')");
+        }
+
+        const std::string no_turbo = details::ReadFirstLine("/sys/devices/system/cpu/intel_pstate/no_turbo");
+        const std::string boost = details::ReadFirstLine("/sys/devices/system/cpu/cpufreq/boost");
+        if (!no_turbo.empty()) {
+            report.turbo_enabled_ = no_turbo == "0";
+        } else if (!boost.empty()) {
+            report.turbo_enabled_ = boost == "1";
+        }
+        if (report.turbo_enabled_.value_or(false)) {
+            report.warnings_.emplace_back("Turbo boost is enabled - frequency depends on load and temperature");
+        }
+
+        report.isolated_ = details::CpuListContains("/sys/devices/system/cpu/isolated", cpu);
+        report.nohz_full_ = details::CpuListContains("/sys/devices/system/cpu/nohz_full", cpu);
+        if (!report.isolated_) {
+            report.warnings_.push_back("CPU " + std::to_string(cpu) + " is not isolated (isolcpus)");
+        }
+        if (!report.nohz_full_) {
+            report.warnings_.push_back("CPU " + std::to_string(cpu) + " receives scheduler ticks (nohz_full)");
+        }
+
+        for (int sibling : details::ParseCpuList(details::ReadFirstLine(cpu_path + "topology/thread_siblings_list"))) {
+            const std::string online = details::ReadFirstLine("/sys/devices/system/cpu/cpu" + std::to_string(sibling) + "/online");
+            if (sibling != cpu && online != "0") {
+                report.smt_siblings_.push_back(sibling);
+            }
+        }
+        if (!report.smt_siblings_.empty()) {
+            report.warnings_.push_back("SMT sibling CPU " + std::to_string(report.smt_siblings_.front()) +
+                                       " of CPU " + std::to_string(cpu) + " is online");
+        }
+
+        std::error_code error{};
+        for (const auto& entry : std::filesystem::directory_iterator{"/proc/irq", error}) {
+            if (!entry.is_directory(error)) {
+                continue;
+            }
+            // Effective affinity is what hardware uses, configured affinity is a superset
+            const std::string path = entry.path().string();
+            std::string list = details::ReadFirstLine(path + "/effective_affinity_list");
+            if (list.empty()) {
+                list = details::ReadFirstLine(path + "/smp_affinity_list");
+            }
+            std::vector<int> cpus = details::ParseCpuList(list);
+            if (std::find(cpus.begin(), cpus.end(), cpu) != cpus.end()) {
+                ++report.irqs_number_;
+            }
+        }
+        if (report.irqs_number_ > 0) {
+            report.warnings_.push_back(std::to_string(report.irqs_number_) + " IRQs may be delivered to CPU " +
+                                       std::to_string(cpu) + " (/proc/irq/*/smp_affinity_list)");
+        }
+        return report;
+    }
+
+} // namespace benchmarking
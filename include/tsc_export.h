@@ -0,0 +1,396 @@
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Linux system includes
+#include <sys/utsname.h>
+#include <unistd.h>
+
+#include "tsc_calibration.h"
+#include "tsc_clock.h"
+#include "tsc_cpu.h"
+#include "tsc_hybrid.h"
+#include "tsc_statistics.h"
+#include "utils/affinity.h"
+#include "utils/types.h"
+
+namespace benchmarking {
+
+    /// Machine and measurement configuration stored with exported results
+    class HostInfo {
+    public:
+        /// Host name
+        std::string hostname_{};
+
+        /// Kernel name and release (uname)
+        std::string kernel_{};
+
+        /// CPU brand string (CPUID 0x80000002..0x80000004)
+        std::string cpu_brand_{};
+
+        /// Number of online CPU cores
+        int cpus_number_{0};
+
+        /// Calibrated TSC frequency in Hz
+        double tsc_hz_{0.0};
+
+        /// Source of TSC calibration
+        CalibrationSource calibration_source_{CalibrationSource::kNone};
+
+        /// Barrier of benchmark clock
+        Barrier barrier_{Barrier::kOneCpuId};
+
+        /// CPU migration check of benchmark
+        bool check_cpu_migration_{false};
+
+        /// UTC time of collection (ISO 8601)
+        std::string timestamp_{};
+
+        /**
+         * @brief Collect host information
+         * @param calibration TSC calibration of benchmark
+         * @param barrier Barrier of benchmark clock
+         * @param check_cpu_migration CPU migration check of benchmark
+         * @return Host information
+         */
+        static HostInfo Collect(const TSCCalibration& calibration, Barrier barrier, bool check_cpu_migration) {
+            HostInfo info{};
+            char hostname[256]{};
+            if (gethostname(hostname, sizeof(hostname) - 1) == 0) {
+                info.hostname_ = hostname;
+            }
+            utsname name{};
+            if (uname(&name) == 0) {
+                info.kernel_ = std::string{name.sysname} + " " + name.release;
+            }
+            info.cpu_brand_ = details::CpuBrandString();
+            info.cpus_number_ = details::GetCpuCoreCount();
+            info.tsc_hz_ = calibration.Frequency();
+            info.calibration_source_ = calibration.Source();
+            info.barrier_ = barrier;
+            info.check_cpu_migration_ = check_cpu_migration;
+
+            const std::time_t now = std::time(nullptr);
+            std::tm utc{};
+            gmtime_r(&now, &utc);
+            char timestamp[32]{};
+            std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", &utc);
+            info.timestamp_ = timestamp;
+            return info;
+        }
+    };
+
+    /// Flattened benchmark result independent of TSCBenchmarking template parameters
+    class ExportedResult {
+    public:
+        /// Benchmark name
+        std::string name_{};
+
+        /// 0-based repetition index
+        std::size_t repetition_{0};
+
+        /// Number of accepted samples
+        std::size_t samples_number_{0};
+
+        /// Number of code invocations per sample
+        std::size_t batch_size_{1};
+
+        /// Average raw and corrected time in TSC ticks
+        TimePoint time_{0}, corrected_time_{0};
+
+        /// Minimal TSC overhead and overhead subtracted from samples in TSC ticks
+        TimePoint overhead_{0}, applied_overhead_{0};
+
+        /// Average corrected time of single invocation in TSC ticks
+        double per_op_time_{0.0};
+
+        /// Raw and corrected latency distributions
+        Distribution distribution_{}, corrected_distribution_{};
+
+        /// Fraction of probe time lost to interrupts/SMIs/preemption
+        double noise_score_{0.0};
+
+        /// Core type benchmark ran on
+        CoreType core_type_{CoreType::kUnknown};
+
+        /// Fraction of attempts discarded (CPU migration, non-monotonic or below TSC overhead)
+        double discard_rate_{0.0};
+
+        /// Samples rejected by outlier pipeline (0 if pipeline was disabled)
+        std::size_t rejected_number_{0};
+
+        /// Bimodality coefficient of samples (0 if pipeline was disabled)
+        double bimodality_coefficient_{0.0};
+
+        /// Raw samples in measurement order (empty unless Settings::record_samples_ was set)
+        std::vector<TimePoint> samples_{};
+    };
+
+    /// Comparison of one benchmark against stored baseline
+    class BaselineComparison {
+    public:
+        /// Benchmark name
+        std::string name_{};
+
+        /// Median of baseline and current samples in TSC ticks
+        TimePoint baseline_median_{0}, current_median_{0};
+
+        /// (current - baseline) / baseline of medians
+        double relative_change_{0.0};
+
+        /// Mann-Whitney U test of current against baseline samples
+        MannWhitneyResult test_{};
+
+        /// Current is significantly slower by more than threshold
+        bool regression_{false};
+
+        /// Current is significantly faster by more than threshold
+        bool improvement_{false};
+    };
+
+    namespace details {
+        /// Write string as JSON string literal
+        inline void WriteJsonString(std::ostream& out, const std::string& value) {
+            out << '"';
+            for (char c : value) {
+                switch (c) {
+                    case '"': out << "\\\""; break;
+                    case '\\': out << "\\\\"; break;
+                    case '\n': out << "\\n"; break;
+                    case '\t': out << "\\t"; break;
+                    default:
+                        if (static_cast<unsigned char>(c) < 0x20) {
+                            out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c)
+                                << std::dec << std::setfill(' ');
+                        } else {
+                            out << c;
+                        }
+                }
+            }
+            out << '"';
+        }
+
+        inline void WriteJsonDistribution(std::ostream& out, const Distribution& distribution) {
+            out << "{\"samples\": " << distribution.samples_number_ << ", \"min\": " << distribution.min_
+                << ", \"median\": " << distribution.median_ << ", \"p90\": " << distribution.p90_
+                << ", \"p99\": " << distribution.p99_ << ", \"p999\": " << distribution.p999_
+                << ", \"max\": " << distribution.max_ << ", \"mad\": " << distribution.mad_
+                << ", \"mean\": " << distribution.mean_ << ", \"stddev\": " << distribution.stddev_ << '}';
+        }
+    } // namespace details
+
+    /**
+     * @brief Collects named results and writes them as JSON or CSV
+     *
+     * All values are written in TSC ticks together with TSC frequency, so nanoseconds can be
+     * derived by consumers. Samples CSV can be loaded back with LoadSamplesCsv() as baseline.
+     *
+     * Example usage:
+     * @code
+     * ResultExporter exporter{HostInfo::Collect(benchmark.GetCalibration(), Benchmark::kBarrier,
+     *                                           Benchmark::kCheckCpuMigration)};
+     * exporter.Add("push_back", result);
+     * exporter.WriteJson(file);
+     * @endcode
+     */
+    class ResultExporter {
+    public:
+        explicit ResultExporter(HostInfo host) : host_{std::move(host)} {}
+
+        /**
+         * @brief Add result of benchmark run
+         * @tparam Result TSCBenchmarking<...>::Result
+         * @param name Benchmark name
+         * @param result Benchmark result
+         * @param repetition Repetition index
+         */
+        template<typename Result>
+        void Add(std::string name, const Result& result, std::size_t repetition = 0) {
+            ExportedResult exported{};
+            exported.name_ = std::move(name);
+            exported.repetition_ = repetition;
+            exported.samples_number_ = result.samples_number_;
+            exported.batch_size_ = result.batch_size_;
+            exported.time_ = result.time_;
+            exported.corrected_time_ = result.corrected_time_;
+            exported.overhead_ = result.overhead_;
+            exported.applied_overhead_ = result.applied_overhead_;
+            exported.per_op_time_ = result.per_op_time_;
+            exported.distribution_ = result.distribution_;
+            exported.corrected_distribution_ = result.corrected_distribution_;
+            exported.noise_score_ = result.noise_score_;
+            exported.core_type_ = result.core_type_;
+            exported.discard_rate_ = result.discard_rate_;
+            exported.rejected_number_ = result.outliers_.rejected_number_;
+            exported.bimodality_coefficient_ = result.outliers_.bimodality_coefficient_;
+            exported.samples_ = result.samples_;
+            results_.push_back(std::move(exported));
+        }
+
+        /// Host information written with results
+        [[nodiscard]] const HostInfo& Host() const noexcept { return host_; }
+
+        /// Collected results in order they were added
+        [[nodiscard]] const std::vector<ExportedResult>& Results() const noexcept { return results_; }
+
+        /// Write host information and result summaries (without raw samples) as JSON
+        void WriteJson(std::ostream& out) const;
+
+        /// Write one summary row per result as CSV
+        void WriteCsv(std::ostream& out) const;
+
+        /// Write raw samples as CSV rows name,repetition,index,ticks
+        void WriteSamplesCsv(std::ostream& out) const;
+
+        /// Samples of every benchmark with all repetitions concatenated
+        [[nodiscard]] std::map<std::string, std::vector<TimePoint>> SamplesByName() const {
+            std::map<std::string, std::vector<TimePoint>> samples;
+            for (const ExportedResult& result : results_) {
+                auto& named = samples[result.name_];
+                named.insert(named.end(), result.samples_.begin(), result.samples_.end());
+            }
+            return samples;
+        }
+
+    private:
+        HostInfo host_{};
+        std::vector<ExportedResult> results_{};
+    };
+
+    /**
+     * @brief Load samples written by ResultExporter::WriteSamplesCsv()
+     * @param in Input stream
+     * @param samples Output samples by benchmark name (repetitions concatenated)
+     * @return false if stream is not a samples CSV
+     */
+    inline bool LoadSamplesCsv(std::istream& in, std::map<std::string, std::vector<TimePoint>>& samples) {
+        std::string line;
+        if (!std::getline(in, line) || line.rfind("name,repetition,index,ticks", 0) != 0) {
+            std::cerr << "[Warning] Unexpected samples CSV header" << std::endl;
+            return false;
+        }
+        while (std::getline(in, line)) {
+            // Name may contain commas, numeric columns are the last three
+            std::size_t ticks = line.rfind(',');
+            std::size_t index = ticks == std::string::npos ? ticks : line.rfind(',', ticks - 1);
+            std::size_t repetition = index == std::string::npos ? index : line.rfind(',', index - 1);
+            if (repetition == std::string::npos) {
+                continue;
+            }
+            samples[line.substr(0, repetition)].push_back(std::stoull(line.substr(ticks + 1)));
+        }
+        return true;
+    }
+
+    /**
+     * @brief Compare current samples against baseline with Mann-Whitney U test
+     * @param baseline Baseline samples by name
+     * @param current Current samples by name
+     * @param alpha Significance level of two-sided test
+     * @param threshold Minimal relative change of median that is reported
+     * @return One comparison per benchmark present in both sets
+     */
+    inline std::vector<BaselineComparison> CompareToBaseline(const std::map<std::string, std::vector<TimePoint>>& baseline,
+                                                             const std::map<std::string, std::vector<TimePoint>>& current,
+                                                             double alpha = 0.01, double threshold = 0.02) {
+        std::vector<BaselineComparison> comparisons;
+        for (const auto& [name, current_samples] : current) {
+            auto found = baseline.find(name);
+            if (found == baseline.end() || found->second.empty() || current_samples.empty()) {
+                continue;
+            }
+            BaselineComparison comparison{};
+            comparison.name_ = name;
+            comparison.test_ = MannWhitneyU(current_samples, found->second);
+
+            std::vector<TimePoint> scratch = found->second;
+            comparison.baseline_median_ = ComputeQuantileInterval(scratch, 0.5).estimate_;
+            scratch = current_samples;
+            comparison.current_median_ = ComputeQuantileInterval(scratch, 0.5).estimate_;
+            if (comparison.baseline_median_ > 0) {
+                comparison.relative_change_ = (static_cast<double>(comparison.current_median_) -
+                                               static_cast<double>(comparison.baseline_median_)) /
+                                              static_cast<double>(comparison.baseline_median_);
+            }
+            const bool significant = comparison.test_.p_value_ < alpha;
+            comparison.regression_ = significant && comparison.relative_change_ > threshold;
+            comparison.improvement_ = significant && comparison.relative_change_ < -threshold;
+            comparisons.push_back(std::move(comparison));
+        }
+        return comparisons;
+    }
+
+
+    // Implementation
+    inline void ResultExporter::WriteJson(std::ostream& out) const {
+        out << "{\n  \"host\": {\"hostname\": ";
+        details::WriteJsonString(out, host_.hostname_);
+        out << ", \"kernel\": ";
+        details::WriteJsonString(out, host_.kernel_);
+        out << ", \"cpu_brand\": ";
+        details::WriteJsonString(out, host_.cpu_brand_);
+        out << ", \"cpus\": " << host_.cpus_number_ << ", \"timestamp\": ";
+        details::WriteJsonString(out, host_.timestamp_);
+        out << "},\n  \"calibration\": {\"tsc_hz\": " << std::fixed << std::setprecision(0) << host_.tsc_hz_
+            << std::defaultfloat << std::setprecision(6) << ", \"source\": ";
+        details::WriteJsonString(out, ToString(host_.calibration_source_));
+        out << "},\n  \"barrier\": ";
+        details::WriteJsonString(out, ToString(host_.barrier_));
+        out << ",\n  \"check_cpu_migration\": " << (host_.check_cpu_migration_ ? "true" : "false")
+            << ",\n  \"results\": [";
+        for (std::size_t i = 0; i < results_.size(); ++i) {
+            const ExportedResult& result = results_[i];
+            out << (i ? ",\n    {" : "\n    {") << "\"name\": ";
+            details::WriteJsonString(out, result.name_);
+            out << ", \"repetition\": " << result.repetition_ << ", \"samples\": " << result.samples_number_
+                << ", \"batch_size\": " << result.batch_size_ << ", \"time\": " << result.time_
+                << ", \"corrected_time\": " << result.corrected_time_ << ", \"overhead\": " << result.overhead_
+                << ", \"applied_overhead\": " << result.applied_overhead_
+                << ", \"per_op_time\": " << result.per_op_time_ << ", \"noise_score\": " << result.noise_score_
+                << ", \"core_type\": \"" << ToString(result.core_type_) << '"'
+                << ", \"discard_rate\": " << result.discard_rate_ << ", \"rejected\": " << result.rejected_number_
+                << ", \"bimodality\": " << result.bimodality_coefficient_
+                << ",\n     \"distribution\": ";
+            details::WriteJsonDistribution(out, result.distribution_);
+            out << ",\n     \"corrected_distribution\": ";
+            details::WriteJsonDistribution(out, result.corrected_distribution_);
+            out << '}';
+        }
+        out << "\n  ]\n}\n";
+    }
+
+    inline void ResultExporter::WriteCsv(std::ostream& out) const {
+        out << "name,repetition,samples,batch_size,time,corrected_time,overhead,applied_overhead,per_op_time,"
+               "min,median,p90,p99,p999,max,mad,mean,stddev,noise_score,core_type,discard_rate,rejected,bimodality,tsc_hz,barrier\n";
+        for (const ExportedResult& result : results_) {
+            const Distribution& distribution = result.corrected_distribution_;
+            out << result.name_ << ',' << result.repetition_ << ',' << result.samples_number_ << ','
+                << result.batch_size_ << ',' << result.time_ << ',' << result.corrected_time_ << ','
+                << result.overhead_ << ',' << result.applied_overhead_ << ',' << result.per_op_time_ << ','
+                << distribution.min_ << ',' << distribution.median_ << ',' << distribution.p90_ << ','
+                << distribution.p99_ << ',' << distribution.p999_ << ',' << distribution.max_ << ','
+                << distribution.mad_ << ',' << distribution.mean_ << ',' << distribution.stddev_ << ','
+                << result.noise_score_ << ',' << ToString(result.core_type_) << ',' << result.discard_rate_ << ','
+                << result.rejected_number_ << ',' << result.bimodality_coefficient_ << ',' << std::fixed << std::setprecision(0) << host_.tsc_hz_ << std::defaultfloat << std::setprecision(6)
+                << ',' << ToString(host_.barrier_) << '\n';
+        }
+    }
+
+    inline void ResultExporter::WriteSamplesCsv(std::ostream& out) const {
+        out << "name,repetition,index,ticks\n";
+        for (const ExportedResult& result : results_) {
+            for (std::size_t i = 0; i < result.samples_.size(); ++i) {
+                out << result.name_ << ',' << result.repetition_ << ',' << i << ',' << result.samples_[i] << '\n';
+            }
+        }
+    }
+
+} // namespace benchmarking
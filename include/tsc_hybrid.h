@@ -0,0 +1,245 @@
+#pragma once
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "tsc_cpu.h"
+#include "tsc_environment.h"
+#include "utils/affinity.h"
+#include "utils/types.h"
+
+namespace benchmarking {
+
+    /// Core type of hybrid CPU
+    enum class CoreType {
+        kUnknown,           ///< Not a hybrid part or type not enumerated
+        kPerformance,       ///< P-core (CPUID 0x1A type 0x40, sysfs cpu_core)
+        kEfficient          ///< E-core (CPUID 0x1A type 0x20, sysfs cpu_atom)
+    };
+
+    /// Human-readable name of core type
+    inline const char* ToString(CoreType type) noexcept {
+        switch (type) {
+            case CoreType::kUnknown: return "unknown";
+            case CoreType::kPerformance: return "P-core";
+            case CoreType::kEfficient: return "E-core";
+        }
+        return "unknown";
+    }
+
+    /// Set of CPUs benchmark is run on, chosen by core type instead of CPU id
+    enum class CoreClass {
+        kAll,               ///< Every online CPU
+        kPerformance,       ///< All P-cores
+        kEfficient,         ///< All E-cores
+        kOneOfEach          ///< First P-core and first E-core
+    };
+
+    /// Human-readable name of core class
+    inline const char* ToString(CoreClass core_class) noexcept {
+        switch (core_class) {
+            case CoreClass::kAll: return "all";
+            case CoreClass::kPerformance: return "performance";
+            case CoreClass::kEfficient: return "efficient";
+            case CoreClass::kOneOfEach: return "one_of_each";
+        }
+        return "unknown";
+    }
+
+    namespace details {
+        /// Map CPUID leaf 0x1A core type to CoreType
+        inline CoreType CoreTypeFromCpuId(std::uint8_t core_type) noexcept {
+            switch (core_type) {
+                case 0x40: return CoreType::kPerformance;
+                case 0x20: return CoreType::kEfficient;
+                default: return CoreType::kUnknown;
+            }
+        }
+
+        /**
+         * @brief Core type of every CPU (collected once per process)
+         *
+         * sysfs PMU cpu lists (/sys/devices/cpu_core/cpus, /sys/devices/cpu_atom/cpus) are used if
+         * present, otherwise CPUID leaf 0x1A of every CPU from GetCpuTopology().
+         *
+         * @return Core types indexed by CPU number (empty on non-hybrid parts)
+         */
+        inline const std::vector<CoreType>& GetCoreTypes() {
+            static const std::vector<CoreType> types = []() {
+                std::vector<CoreType> result;
+                if (!CpuInfo::Instance().IsHybrid()) {
+                    return result;
+                }
+                result.assign(static_cast<std::size_t>(GetCpuCoreCount()), CoreType::kUnknown);
+                auto assign = [&result](const std::vector<int>& cpus, CoreType type) {
+                    for (int cpu : cpus) {
+                        if (cpu >= 0 && static_cast<std::size_t>(cpu) < result.size()) {
+                            result[static_cast<std::size_t>(cpu)] = type;
+                        }
+                    }
+                };
+                std::vector<int> performance = ParseCpuList(ReadFirstLine("/sys/devices/cpu_core/cpus"));
+                std::vector<int> efficient = ParseCpuList(ReadFirstLine("/sys/devices/cpu_atom/cpus"));
+                if (!performance.empty() || !efficient.empty()) {
+                    assign(performance, CoreType::kPerformance);
+                    assign(efficient, CoreType::kEfficient);
+                } else {
+                    for (const CpuTopology& cpu : GetCpuTopology()) {
+                        assign({cpu.cpu_}, CoreTypeFromCpuId(cpu.core_type_));
+                    }
+                }
+                return result;
+            }();
+            return types;
+        }
+    } // namespace details
+
+    /// Core type of CPU (kUnknown on non-hybrid parts)
+    inline CoreType GetCoreType(int cpu) {
+        const std::vector<CoreType>& types = details::GetCoreTypes();
+        return cpu >= 0 && static_cast<std::size_t>(cpu) < types.size() ? types[static_cast<std::size_t>(cpu)]
+                                                                         : CoreType::kUnknown;
+    }
+
+    /**
+     * @brief CPUs of core class
+     *
+     * On non-hybrid parts every CPU belongs to every class (kOneOfEach selects a single CPU).
+     *
+     * @param core_class Core class
+     * @return CPU numbers in placement order (GetPlacementCpuList())
+     */
+    inline std::vector<int> SelectCores(CoreClass core_class) {
+        std::vector<int> all = details::GetPlacementCpuList();
+        if (details::GetCoreTypes().empty() || core_class == CoreClass::kAll) {
+            if (core_class == CoreClass::kOneOfEach && !all.empty()) {
+                all.erase(all.begin() + 1, all.end());
+            }
+            return all;
+        }
+        std::vector<int> cpus;
+        bool performance_found = false, efficient_found = false;
+        for (int cpu : all) {
+            const CoreType type = GetCoreType(cpu);
+            if (core_class == CoreClass::kPerformance && type == CoreType::kPerformance) {
+                cpus.push_back(cpu);
+            } else if (core_class == CoreClass::kEfficient && type == CoreType::kEfficient) {
+                cpus.push_back(cpu);
+            } else if (core_class == CoreClass::kOneOfEach) {
+                if (type == CoreType::kPerformance && !performance_found) {
+                    performance_found = true;
+                    cpus.push_back(cpu);
+                } else if (type == CoreType::kEfficient && !efficient_found) {
+                    efficient_found = true;
+                    cpus.push_back(cpu);
+                }
+            }
+        }
+        if (cpus.empty()) {
+            std::cerr << "[Warning] No CPUs of core class " << ToString(core_class) << std::endl;
+        }
+        return cpus;
+    }
+
+    /// Run of benchmark on one CPU of core class
+    template<typename Result>
+    class CoreRun {
+    public:
+        /// CPU core benchmark was pinned to
+        int cpu_{0};
+
+        /// Core type of cpu_
+        CoreType core_type_{CoreType::kUnknown};
+
+        /// Minimal TSC overhead measured on cpu_ before the run in clock ticks
+        TimePoint overhead_{0};
+
+        /// Benchmark result
+        Result result_{};
+    };
+
+    /// Results of one core type
+    class CoreTypeSummary {
+    public:
+        /// Core type
+        CoreType core_type_{CoreType::kUnknown};
+
+        /// CPUs measured
+        std::vector<int> cpus_{};
+
+        /// Median over CPUs of per-CPU corrected medians (corrected means if samples were not recorded) in TSC ticks
+        TimePoint median_time_{0};
+
+        /// Fastest and slowest CPU of type in TSC ticks
+        TimePoint min_time_{0}, max_time_{0};
+    };
+
+    /**
+     * @brief Benchmark code on every CPU of core class
+     *
+     * Overheads are re-measured on every CPU before its run (Benchmark::MeasureOverheadOn()), so
+     * correction and sample rejection use fence cost of that core type. Afterwards they are
+     * measured again on Settings::cpu_ passed in.
+     *
+     * @tparam Benchmark TSCBenchmarking<...> (already initialized)
+     * @param benchmark Benchmark instance
+     * @param code Code to benchmark
+     * @param core_class CPUs to run on
+     * @param settings Settings of every Run() (cpu_ is replaced)
+     * @return One run per selected CPU
+     */
+    template<typename Benchmark, typename Code>
+    std::vector<CoreRun<typename Benchmark::Result>> RunOnCoreClass(Benchmark& benchmark, Code&& code, CoreClass core_class,
+                                                                    typename Benchmark::Settings settings) {
+        std::vector<CoreRun<typename Benchmark::Result>> runs;
+        const int home_cpu = settings.cpu_;
+        for (int cpu : SelectCores(core_class)) {
+            settings.cpu_ = cpu;
+            CoreRun<typename Benchmark::Result> run{};
+            run.cpu_ = cpu;
+            run.core_type_ = GetCoreType(cpu);
+            run.overhead_ = benchmark.MeasureOverheadOn(cpu, settings);
+            run.result_ = benchmark.Run(code, settings);
+            runs.push_back(std::move(run));
+        }
+        if (!runs.empty()) {
+            benchmark.MeasureOverheadOn(home_cpu, settings);
+        }
+        return runs;
+    }
+
+    /**
+     * @brief Group runs by core type
+     * @param runs Runs from RunOnCoreClass()
+     * @return One summary per core type present, in order of CoreType enumerators
+     */
+    template<typename Result>
+    std::vector<CoreTypeSummary> GroupByCoreType(const std::vector<CoreRun<Result>>& runs) {
+        std::vector<CoreTypeSummary> summaries;
+        for (CoreType type : {CoreType::kUnknown, CoreType::kPerformance, CoreType::kEfficient}) {
+            std::vector<TimePoint> times;
+            CoreTypeSummary summary{};
+            summary.core_type_ = type;
+            for (const CoreRun<Result>& run : runs) {
+                if (run.core_type_ == type) {
+                    summary.cpus_.push_back(run.cpu_);
+                    const Result& result = run.result_;
+                    times.push_back(result.corrected_distribution_.samples_number_ > 0 ? result.corrected_distribution_.median_
+                                                                                          : result.corrected_time_);
+                }
+            }
+            if (times.empty()) {
+                continue;
+            }
+            std::sort(times.begin(), times.end());
+            summary.median_time_ = times[times.size() / 2];
+            summary.min_time_ = times.front();
+            summary.max_time_ = times.back();
+            summaries.push_back(std::move(summary));
+        }
+        return summaries;
+    }
+
+} // namespace benchmarking
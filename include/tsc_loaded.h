@@ -0,0 +1,328 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include "tsc_cache.h"
+#include "tsc_calibration.h"
+#include "tsc_cpu.h"
+#include "utils/affinity.h"
+#include "utils/compiler.h"
+#include "utils/types.h"
+
+namespace benchmarking {
+
+    /// Background pressure generated by aggressor threads
+    enum class AggressorKind {
+        kBandwidth,     ///< Streaming reads and writes over buffer larger than LLC (memory bandwidth)
+        kLlcThrash,     ///< Random line accesses over LLC-sized buffer (evicts target's LLC lines)
+        kCompute        ///< Dependent vector FMA chains (AVX2 if available - power/frequency pressure)
+    };
+
+    /// Human-readable name of aggressor kind
+    inline const char* ToString(AggressorKind kind) noexcept {
+        switch (kind) {
+            case AggressorKind::kBandwidth: return "bandwidth";
+            case AggressorKind::kLlcThrash: return "llc_thrash";
+            case AggressorKind::kCompute: return "compute";
+        }
+        return "unknown";
+    }
+
+    /// Configuration of loaded-latency sweep
+    class LoadSettings {
+    public:
+        /// Kind of background pressure
+        AggressorKind kind_{AggressorKind::kBandwidth};
+
+        /// CPU cores of aggressors (CPU of benchmark is skipped)
+        std::vector<int> cpus_{};
+
+        /// Duty cycles of aggressors, one curve point per entry (0 - idle baseline, 1 - continuous)
+        std::vector<double> intensities_{0.0, 0.25, 0.5, 0.75, 1.0};
+
+        /// Per-aggressor buffer in bytes (0 - 2x LLC for kBandwidth, LLC size for kLlcThrash, capped at 256 MiB)
+        std::size_t buffer_bytes_{0};
+
+        /// Duty cycle period - aggressor works intensity * period, then pauses for the rest
+        std::chrono::microseconds period_{100};
+
+        /// Time aggressors run before measurement starts
+        std::chrono::milliseconds ramp_up_{5};
+    };
+
+    /// One point of loaded-latency curve
+    template<typename Result>
+    class LoadedLatencyPoint {
+    public:
+        /// Duty cycle of aggressors
+        double intensity_{0.0};
+
+        /// Number of aggressors pinned to their CPU (unpinned ones exit without load)
+        std::size_t aggressors_number_{0};
+
+        /// Bytes (kCompute - vector operations) processed by all aggressors per second during measurement
+        double aggressor_throughput_{0.0};
+
+        /// Benchmark result under load
+        Result result_{};
+    };
+
+    namespace details {
+        /// Aggressor buffers are capped so that mlockall() of Initialize() does not run out of memory
+        inline constexpr std::size_t kMaxAggressorBytes = std::size_t{256} << 20;
+
+        /// Default buffer of aggressor kind
+        inline std::size_t DefaultAggressorBytes(AggressorKind kind) {
+            const std::vector<CacheLevel> levels = ReadCacheLevels();
+            const std::size_t llc = levels.empty() ? std::size_t{32} << 20 : levels.back().size_bytes_;
+            const std::size_t bytes = kind == AggressorKind::kBandwidth ? llc * 2 : llc;
+            return std::min(bytes, kMaxAggressorBytes);
+        }
+
+        /// Stream over buffer with 64-byte stride read-modify-write, return bytes touched
+        inline std::size_t StreamChunk(std::uint64_t* buffer, std::size_t words, std::size_t& position) noexcept {
+            constexpr std::size_t kChunkWords = 4096;
+            const std::size_t begin = position;
+            const std::size_t end = std::min(words, begin + kChunkWords);
+            for (std::size_t i = begin; i < end; i += kCacheLineSize / sizeof(std::uint64_t)) {
+                buffer[i] += 1;
+            }
+            position = end == words ? 0 : end;
+            return (end - begin) * sizeof(std::uint64_t);
+        }
+
+        /// Random line increments over buffer (xorshift index), return bytes touched (one line per access)
+        inline std::size_t ThrashChunk(std::uint64_t* buffer, std::size_t lines, std::uint64_t& state) noexcept {
+            constexpr std::size_t kChunkLines = 256;
+            constexpr std::size_t kLineWords = kCacheLineSize / sizeof(std::uint64_t);
+            for (std::size_t i = 0; i < kChunkLines; ++i) {
+                state ^= state << 13;
+                state ^= state >> 7;
+                state ^= state << 17;
+                buffer[(state % lines) * kLineWords] += 1;
+            }
+            return kChunkLines * kCacheLineSize;
+        }
+
+        using Vector4d = double __attribute__((vector_size(32)));
+
+        /// Eight independent multiply-add chains of 4 doubles, return number of vector operations
+        FORCE_INLINE std::size_t ComputeKernel(Vector4d* accumulators) noexcept {
+            constexpr std::size_t kIterations = 256;
+            const Vector4d multiplier = {1.0000001, 1.0000001, 1.0000001, 1.0000001};
+            const Vector4d addend = {1e-9, 1e-9, 1e-9, 1e-9};
+            for (std::size_t i = 0; i < kIterations; ++i) {
+                for (std::size_t j = 0; j < 8; ++j) {
+                    accumulators[j] = accumulators[j] * multiplier + addend;
+                }
+            }
+            return kIterations * 8;
+        }
+
+        /// Kernel compiled to 256-bit FMA (call only if AVX2 and FMA are supported)
+        __attribute__((target("avx2,fma"))) inline std::size_t ComputeChunkAvx2(Vector4d* accumulators) noexcept {
+            return ComputeKernel(accumulators);
+        }
+
+        /// Kernel compiled for baseline ISA
+        inline std::size_t ComputeChunk(Vector4d* accumulators) noexcept { return ComputeKernel(accumulators); }
+    } // namespace details
+
+    /**
+     * @brief Pinned background threads generating memory or compute pressure at given duty cycle
+     *
+     * Aggressors run with SCHED_OTHER even if creating thread is SCHED_FIFO, so they can never
+     * starve measured thread. Each aggressor allocates and first-touches its own buffer on its core.
+     */
+    class AggressorPool {
+    public:
+        AggressorPool() = default;
+        AggressorPool(const AggressorPool&) = delete;
+        AggressorPool& operator=(const AggressorPool&) = delete;
+
+        ~AggressorPool() { Stop(); }
+
+        /**
+         * @brief Start one aggressor per CPU
+         * @param kind Kind of pressure
+         * @param cpus CPU cores of aggressors
+         * @param intensity Duty cycle in [0, 1]
+         * @param buffer_bytes Per-aggressor buffer (0 - default of kind)
+         * @param period Duty cycle period
+         * @param calibration TSC calibration for duty cycle timing
+         */
+        void Start(AggressorKind kind, const std::vector<int>& cpus, double intensity, std::size_t buffer_bytes,
+                   std::chrono::microseconds period, const TSCCalibration& calibration) {
+            Stop();
+            stop_.store(false, std::memory_order_relaxed);
+            intensity = std::clamp(intensity, 0.0, 1.0);
+            const std::size_t bytes = buffer_bytes > 0 ? buffer_bytes : details::DefaultAggressorBytes(kind);
+            const double period_ticks = calibration.TicksPerNanosecond() * 1e3 * static_cast<double>(period.count());
+            const auto busy_ticks = static_cast<TimePoint>(period_ticks * intensity);
+            const auto period_length = static_cast<TimePoint>(period_ticks);
+            counters_ = std::make_unique<Counter[]>(cpus.size());
+            for (std::size_t index = 0; index < cpus.size(); ++index) {
+                threads_.emplace_back([this, kind, cpu = cpus[index], bytes, busy_ticks, period_length, index]() {
+                    Work(kind, cpu, bytes, busy_ticks, period_length, counters_[index]);
+                });
+            }
+            counters_number_ = cpus.size();
+
+            // Wait for pinning outcome so that Size() only counts aggressors running on their CPU
+            for (std::size_t index = 0; index < counters_number_; ++index) {
+                while (counters_[index].pinned_.load(std::memory_order_acquire) == kPinPending) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        /// Stop and join aggressors
+        void Stop() {
+            stop_.store(true, std::memory_order_relaxed);
+            for (std::thread& thread : threads_) {
+                thread.join();
+            }
+            threads_.clear();
+        }
+
+        /// Units (bytes or vector operations) processed by all aggressors so far
+        [[nodiscard]] std::uint64_t Processed() const noexcept {
+            std::uint64_t total = 0;
+            for (std::size_t index = 0; index < counters_number_; ++index) {
+                total += counters_[index].value_.load(std::memory_order_relaxed);
+            }
+            return total;
+        }
+
+        /// Number of aggressors pinned to their CPU (others exit without generating load)
+        [[nodiscard]] std::size_t Size() const noexcept {
+            std::size_t pinned = 0;
+            for (std::size_t index = 0; index < counters_number_; ++index) {
+                pinned += counters_[index].pinned_.load(std::memory_order_relaxed) == kPinned ? 1 : 0;
+            }
+            return pinned;
+        }
+
+    private:
+        static constexpr int kPinPending = 0, kPinned = 1, kPinFailed = 2;
+
+        struct alignas(kCacheLineSize) Counter {
+            std::atomic<std::uint64_t> value_{0};
+            std::atomic<int> pinned_{kPinPending};
+        };
+
+        void Work(AggressorKind kind, int cpu, std::size_t bytes, TimePoint busy_ticks, TimePoint period_ticks,
+                  Counter& counter) {
+            sched_param param{};
+            pthread_setschedparam(pthread_self(), SCHED_OTHER, &param);
+            // Unpinned aggressor would inherit creator's affinity and load measured core
+            if (!details::PinThread(cpu, false)) {
+                std::cerr << "[Warning] Aggressor could not be pinned to CPU " << cpu << " - skipped" << std::endl;
+                counter.pinned_.store(kPinFailed, std::memory_order_release);
+                return;
+            }
+            counter.pinned_.store(kPinned, std::memory_order_release);
+            std::atomic<std::uint64_t>& processed = counter.value_;
+
+            const std::size_t words = kind == AggressorKind::kCompute ? 0 : std::max<std::size_t>(bytes / sizeof(std::uint64_t), 4096);
+            std::unique_ptr<std::uint64_t[]> buffer{words > 0 ? new std::uint64_t[words]() : nullptr};
+            alignas(32) details::Vector4d accumulators[8];
+            for (auto& accumulator : accumulators) {
+                accumulator = details::Vector4d{1.0, 2.0, 3.0, 4.0};
+            }
+            const bool avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+            const std::size_t lines = words * sizeof(std::uint64_t) / kCacheLineSize;
+            std::size_t position = 0;
+            std::uint64_t state = 0x9E3779B97F4A7C15ULL ^ static_cast<std::uint64_t>(cpu);
+
+            while (!stop_.load(std::memory_order_relaxed)) {
+                const TimePoint begin = details::Rdtsc();
+                std::uint64_t units = 0;
+                for (TimePoint now = begin; now - begin < busy_ticks; now = details::Rdtsc()) {
+                    switch (kind) {
+                        case AggressorKind::kBandwidth: units += details::StreamChunk(buffer.get(), words, position); break;
+                        case AggressorKind::kLlcThrash: units += details::ThrashChunk(buffer.get(), lines, state); break;
+                        case AggressorKind::kCompute:
+                            units += avx2 ? details::ComputeChunkAvx2(accumulators) : details::ComputeChunk(accumulators);
+                            break;
+                    }
+                }
+                processed.fetch_add(units, std::memory_order_relaxed);
+                while (details::Rdtsc() - begin < period_ticks && !stop_.load(std::memory_order_relaxed)) {
+                    CPU_RELAX();
+                }
+            }
+            DoNotOptimize(accumulators);
+        }
+
+        std::vector<std::thread> threads_{};
+        std::unique_ptr<Counter[]> counters_{};
+        std::size_t counters_number_{0};
+        std::atomic<bool> stop_{false};
+    };
+
+    /**
+     * @brief Latency of code as function of background pressure (loaded-latency curve)
+     *
+     * For every intensity aggressors are started on LoadSettings::cpus_, given ramp-up time and
+     * kept running while benchmark.Run() measures code on Settings::cpu_.
+     *
+     * @tparam Benchmark TSCBenchmarking<...> (already initialized)
+     * @param benchmark Benchmark instance
+     * @param code Code to benchmark
+     * @param load Aggressor configuration
+     * @param settings Settings of every Run()
+     * @return One point per intensity
+     */
+    template<typename Benchmark, typename Code>
+    std::vector<LoadedLatencyPoint<typename Benchmark::Result>> RunLoaded(Benchmark& benchmark, Code&& code,
+                                                                          const LoadSettings& load,
+                                                                          typename Benchmark::Settings settings) {
+        std::vector<int> cpus;
+        std::copy_if(load.cpus_.begin(), load.cpus_.end(), std::back_inserter(cpus),
+                     [&settings](int cpu) { return cpu != settings.cpu_; });
+        if (cpus.size() != load.cpus_.size()) {
+            std::cerr << "[Warning] Aggressor on benchmark CPU " << settings.cpu_ << " skipped" << std::endl;
+        }
+
+        const TSCCalibration& calibration = benchmark.GetTscCalibration();
+        if (!calibration.IsCalibrated()) {
+            std::cerr << "[Warning] TSC is not calibrated - aggressor duty cycle and throughput assume 1 GHz" << std::endl;
+        }
+        std::vector<LoadedLatencyPoint<typename Benchmark::Result>> curve;
+        for (double intensity : load.intensities_) {
+            LoadedLatencyPoint<typename Benchmark::Result> point{};
+            point.intensity_ = intensity;
+            AggressorPool pool{};
+            if (intensity > 0.0 && !cpus.empty()) {
+                pool.Start(load.kind_, cpus, intensity, load.buffer_bytes_, load.period_, calibration);
+                std::this_thread::sleep_for(load.ramp_up_);
+            }
+            point.aggressors_number_ = pool.Size();
+            const std::uint64_t processed_begin = pool.Processed();
+            const TimePoint begin = details::Rdtsc();
+            point.result_ = benchmark.Run(code, settings);
+            const TimePoint end = details::Rdtsc();
+            const std::uint64_t processed_end = pool.Processed();
+            pool.Stop();
+            if (end > begin) {
+                point.aggressor_throughput_ = static_cast<double>(processed_end - processed_begin) * calibration.Frequency()
+                                              / static_cast<double>(end - begin);
+            }
+            curve.push_back(std::move(point));
+        }
+        return curve;
+    }
+
+} // namespace benchmarking
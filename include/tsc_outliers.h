@@ -0,0 +1,281 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "tsc_statistics.h"
+#include "utils/types.h"
+
+namespace benchmarking {
+
+    /// Reason sample was rejected (bit flags of OutlierReport tags)
+    enum class OutlierTag : std::uint8_t {
+        kKept = 0,              ///< Sample kept
+        kTukey = 1,             ///< Outside Tukey fences
+        kMad = 2,               ///< Further than OutlierSettings::mad_threshold_ scaled MADs from median
+        /// At least noise detector's gap threshold above median. Samples carry no timestamps, so they
+        /// are not matched against gaps the detector observed - duration alone marks a likely interrupt/SMI hit
+        kInterruptGap = 4
+    };
+
+    /// True if tag set contains tag
+    inline bool HasTag(std::uint8_t tags, OutlierTag tag) noexcept {
+        return (tags & static_cast<std::uint8_t>(tag)) != 0;
+    }
+
+    /// Configuration of outlier pipeline applied to recorded samples
+    class OutlierSettings {
+    public:
+        /// Run pipeline on recorded samples of Run()/RunAdaptive() (Result::outliers_)
+        bool enabled_{false};
+
+        /// Reject samples outside Tukey fences [Q1 - k * IQR, Q3 + k * IQR]
+        bool tukey_{true};
+
+        /// Fence multiplier k (1.5 - mild outliers, 3 - far out)
+        double tukey_k_{3.0};
+
+        /// Reject samples further than mad_threshold_ * 1.4826 * MAD from median
+        bool mad_{true};
+
+        /// Number of scaled MADs (robust standard deviations)
+        double mad_threshold_{5.0};
+
+        /// Reject samples exceeding median by at least noise detector's gap threshold
+        bool interrupt_gaps_{true};
+
+        /// Also apply lower fences (fast samples are usually genuine, so off by default)
+        bool reject_low_{false};
+
+        /// Skip Tukey/MAD rejection if distribution is bimodal, so that second mode is not cut off
+        bool preserve_modes_{true};
+
+        /// Bimodality coefficient above which distribution is bimodal (5/9 - value of uniform distribution)
+        double bimodality_threshold_{5.0 / 9.0};
+
+        /// Minimal fraction of samples beyond Tukey/MAD limits that can form second mode - a few isolated
+        /// samples raise bimodality coefficient as well, but rejecting them never cuts off a mode
+        double min_mode_fraction_{0.05};
+    };
+
+    /// Outcome of outlier pipeline (values in ticks of samples)
+    class OutlierReport {
+    public:
+        /// Samples kept and rejected
+        std::size_t kept_number_{0}, rejected_number_{0};
+
+        /// Rejected samples per reason (sample may have several reasons)
+        std::size_t tukey_number_{0}, mad_number_{0}, interrupt_gap_number_{0};
+
+        /// Limits samples were checked against (upper limits only apply above median)
+        TimePoint tukey_lower_{0}, tukey_upper_{0}, mad_lower_{0}, mad_upper_{0}, gap_limit_{0};
+
+        /// Sarle's bimodality coefficient of samples without interrupt gaps
+        double bimodality_coefficient_{0.0};
+
+        /// True if bimodality_coefficient_ exceeds OutlierSettings::bimodality_threshold_ and at least
+        /// OutlierSettings::min_mode_fraction_ of samples lie beyond Tukey/MAD limits
+        bool bimodal_{false};
+
+        /// Distribution of all samples
+        Distribution unfiltered_{};
+
+        /// Distribution of kept samples
+        Distribution filtered_{};
+    };
+
+    namespace details {
+        /// Limits of outlier pipeline computed from sample order statistics
+        class OutlierLimits {
+        public:
+            TimePoint tukey_lower_{0}, tukey_upper_{0}, mad_lower_{0}, mad_upper_{0}, gap_limit_{0};
+            double bimodality_coefficient_{0.0};
+            bool bimodal_{false};
+            bool tukey_{false}, mad_{false}, interrupt_gaps_{false};
+            bool reject_low_{false};
+
+            /// Rejection reasons of sample
+            [[nodiscard]] std::uint8_t Classify(TimePoint sample) const noexcept {
+                std::uint8_t tags = 0;
+                if (interrupt_gaps_ && sample >= gap_limit_) {
+                    tags |= static_cast<std::uint8_t>(OutlierTag::kInterruptGap);
+                }
+                if (tukey_ && (sample > tukey_upper_ || (reject_low_ && sample < tukey_lower_))) {
+                    tags |= static_cast<std::uint8_t>(OutlierTag::kTukey);
+                }
+                if (mad_ && (sample > mad_upper_ || (reject_low_ && sample < mad_lower_))) {
+                    tags |= static_cast<std::uint8_t>(OutlierTag::kMad);
+                }
+                return tags;
+            }
+        };
+
+        /**
+         * @brief Sarle's bimodality coefficient (g^2 + 1) / (k + 3 (n-1)^2 / ((n-2)(n-3)))
+         *
+         * g is sample skewness and k sample excess kurtosis. Values above 5/9 (uniform distribution)
+         * suggest two modes; heavy single tails also raise it, so interrupt-hit samples should be
+         * removed first.
+         *
+         * @return Coefficient (0 for fewer than 4 samples or constant samples)
+         */
+        inline double BimodalityCoefficient(std::span<const TimePoint> samples) noexcept {
+            const std::size_t n = samples.size();
+            if (n < 4) {
+                return 0.0;
+            }
+            double mean = 0.0;
+            for (TimePoint sample : samples) {
+                mean += static_cast<double>(sample);
+            }
+            mean /= static_cast<double>(n);
+            double m2 = 0.0, m3 = 0.0, m4 = 0.0;
+            for (TimePoint sample : samples) {
+                const double delta = static_cast<double>(sample) - mean;
+                const double square = delta * delta;
+                m2 += square;
+                m3 += square * delta;
+                m4 += square * square;
+            }
+            const double count = static_cast<double>(n);
+            m2 /= count;
+            m3 /= count;
+            m4 /= count;
+            if (m2 <= 0.0) {
+                return 0.0;
+            }
+            // Bias-corrected skewness and excess kurtosis
+            const double skewness = m3 / std::pow(m2, 1.5) * std::sqrt(count * (count - 1.0)) / (count - 2.0);
+            const double kurtosis = (count - 1.0) / ((count - 2.0) * (count - 3.0))
+                                    * ((count + 1.0) * (m4 / (m2 * m2) - 3.0) + 6.0);
+            const double correction = 3.0 * (count - 1.0) * (count - 1.0) / ((count - 2.0) * (count - 3.0));
+            return (skewness * skewness + 1.0) / (kurtosis + correction);
+        }
+
+        /**
+         * @brief Compute limits of outlier pipeline
+         * @param samples Samples to classify
+         * @param settings Pipeline configuration
+         * @param gap_ticks Interrupt gap threshold in ticks of samples (0 - no gap tagging)
+         * @return Limits (nothing is rejected if there are no samples)
+         */
+        inline OutlierLimits ComputeOutlierLimits(std::span<const TimePoint> samples, const OutlierSettings& settings,
+                                                  TimePoint gap_ticks) {
+            OutlierLimits limits{};
+            const std::size_t n = samples.size();
+            if (n == 0) {
+                return limits;
+            }
+            std::vector<TimePoint> sorted(samples.begin(), samples.end());
+            std::sort(sorted.begin(), sorted.end());
+            const TimePoint median = sorted[QuantileIndex(n, 0.5)];
+
+            // Spreads are floored at one tick so that samples tied at median do not reject every other value
+            auto clamp_tick = [](double value) {
+                return value <= 0.0 ? TimePoint{0} : static_cast<TimePoint>(value);
+            };
+            const TimePoint q1 = sorted[QuantileIndex(n, 0.25)], q3 = sorted[QuantileIndex(n, 0.75)];
+            const double iqr = std::max(static_cast<double>(q3 - q1), 1.0);
+            limits.tukey_lower_ = clamp_tick(static_cast<double>(q1) - settings.tukey_k_ * iqr);
+            limits.tukey_upper_ = clamp_tick(static_cast<double>(q3) + settings.tukey_k_ * iqr);
+
+            std::vector<TimePoint> deviations(sorted);
+            for (TimePoint& deviation : deviations) {
+                deviation = deviation > median ? deviation - median : median - deviation;
+            }
+            auto mad = deviations.begin() + static_cast<std::ptrdiff_t>(QuantileIndex(n, 0.5));
+            std::nth_element(deviations.begin(), mad, deviations.end());
+            const double spread = std::max(1.4826 * static_cast<double>(*mad), 1.0) * settings.mad_threshold_;
+            limits.mad_lower_ = clamp_tick(static_cast<double>(median) - spread);
+            limits.mad_upper_ = clamp_tick(static_cast<double>(median) + spread);
+
+            limits.interrupt_gaps_ = settings.interrupt_gaps_ && gap_ticks > 0;
+            limits.gap_limit_ = median + gap_ticks;
+            limits.tukey_ = settings.tukey_;
+            limits.mad_ = settings.mad_;
+            limits.reject_low_ = settings.reject_low_;
+
+            // Bimodality is judged on samples without interrupt gaps
+            const std::span<const TimePoint> quiet{
+                    sorted.data(), limits.interrupt_gaps_
+                                   ? static_cast<std::size_t>(std::lower_bound(sorted.begin(), sorted.end(), limits.gap_limit_) - sorted.begin())
+                                   : n};
+            limits.bimodality_coefficient_ = BimodalityCoefficient(quiet);
+            const auto beyond = static_cast<std::size_t>(std::count_if(quiet.begin(), quiet.end(),
+                    [&limits](TimePoint sample) { return limits.Classify(sample) != 0; }));
+            limits.bimodal_ = limits.bimodality_coefficient_ > settings.bimodality_threshold_ &&
+                              static_cast<double>(beyond) >= settings.min_mode_fraction_ * static_cast<double>(quiet.size());
+            if (limits.bimodal_ && settings.preserve_modes_) {
+                limits.tukey_ = false;
+                limits.mad_ = false;
+            }
+            return limits;
+        }
+
+        /**
+         * @brief Move kept samples to front of span (order of kept samples is preserved)
+         * @return Number of kept samples
+         */
+        inline std::size_t KeepInliers(std::span<TimePoint> samples, const OutlierSettings& settings, TimePoint gap_ticks) {
+            const OutlierLimits limits = ComputeOutlierLimits(samples, settings, gap_ticks);
+            auto end = std::remove_if(samples.begin(), samples.end(),
+                                      [&limits](TimePoint sample) { return limits.Classify(sample) != 0; });
+            return static_cast<std::size_t>(end - samples.begin());
+        }
+    } // namespace details
+
+    /**
+     * @brief Classify samples with outlier pipeline
+     *
+     * Samples exceeding median by gap_ticks are tagged kInterruptGap: such a sample contains a stall
+     * that noise detector would count as interrupt/SMI gap. Bimodality is measured on remaining samples;
+     * unless distribution is bimodal (and OutlierSettings::preserve_modes_ is set), samples outside
+     * Tukey fences or MAD limit are rejected as well.
+     *
+     * @param samples Samples (order only matters for tags)
+     * @param settings Pipeline configuration
+     * @param gap_ticks Interrupt gap threshold in ticks of samples (0 - no gap tagging)
+     * @param tags Optional output - rejection reasons of every sample (OutlierTag bits, 0 - kept)
+     * @return Counts, limits and filtered/unfiltered distributions
+     */
+    inline OutlierReport ClassifyOutliers(std::span<const TimePoint> samples, const OutlierSettings& settings,
+                                          TimePoint gap_ticks = 0, std::vector<std::uint8_t>* tags = nullptr) {
+        OutlierReport report{};
+        const details::OutlierLimits limits = details::ComputeOutlierLimits(samples, settings, gap_ticks);
+        report.tukey_lower_ = limits.tukey_lower_;
+        report.tukey_upper_ = limits.tukey_upper_;
+        report.mad_lower_ = limits.mad_lower_;
+        report.mad_upper_ = limits.mad_upper_;
+        report.gap_limit_ = limits.gap_limit_;
+        report.bimodality_coefficient_ = limits.bimodality_coefficient_;
+        report.bimodal_ = limits.bimodal_;
+
+        if (tags != nullptr) {
+            tags->assign(samples.size(), 0);
+        }
+        std::vector<TimePoint> all(samples.begin(), samples.end()), kept;
+        kept.reserve(samples.size());
+        for (std::size_t i = 0; i < samples.size(); ++i) {
+            const std::uint8_t sample_tags = limits.Classify(samples[i]);
+            if (tags != nullptr) {
+                (*tags)[i] = sample_tags;
+            }
+            if (sample_tags == 0) {
+                kept.push_back(samples[i]);
+                continue;
+            }
+            report.tukey_number_ += HasTag(sample_tags, OutlierTag::kTukey) ? 1 : 0;
+            report.mad_number_ += HasTag(sample_tags, OutlierTag::kMad) ? 1 : 0;
+            report.interrupt_gap_number_ += HasTag(sample_tags, OutlierTag::kInterruptGap) ? 1 : 0;
+        }
+        report.kept_number_ = kept.size();
+        report.rejected_number_ = samples.size() - kept.size();
+        report.unfiltered_ = ComputeDistribution(all);
+        report.filtered_ = ComputeDistribution(kept);
+        return report;
+    }
+
+} // namespace benchmarking
@@ -0,0 +1,305 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// Linux system includes
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "utils/compiler.h"
+#include "utils/types.h"
+
+namespace benchmarking {
+
+    /// Hardware events that can be counted around measured code
+    enum class PerfEvent {
+        kCycles,            ///< Core clock cycles (not TSC ticks)
+        kInstructions,      ///< Instructions retired
+        kL1dMisses,         ///< L1 data cache read misses
+        kLlcMisses,         ///< Last level cache read misses
+        kBranchMisses,      ///< Mispredicted branches
+        kDtlbMisses         ///< Data TLB read misses
+    };
+
+    /// Human-readable name of event
+    inline const char* ToString(PerfEvent event) noexcept {
+        switch (event) {
+            case PerfEvent::kCycles: return "cycles";
+            case PerfEvent::kInstructions: return "instructions";
+            case PerfEvent::kL1dMisses: return "l1d_misses";
+            case PerfEvent::kLlcMisses: return "llc_misses";
+            case PerfEvent::kBranchMisses: return "branch_misses";
+            case PerfEvent::kDtlbMisses: return "dtlb_misses";
+        }
+        return "unknown";
+    }
+
+    namespace details {
+        /// Read performance monitoring counter (RDPMC instruction)
+        /// @param index Hardware counter index
+        /// @return Raw counter value
+        FORCE_INLINE std::uint64_t Rdpmc(InternalRegister index) noexcept {
+            InternalRegister low, high;
+            __asm__ __volatile__("rdpmc" : "=a"(low), "=d"(high) : "c"(index));
+            return (static_cast<std::uint64_t>(high) << 32) | low;
+        }
+
+        /// perf_event_attr type/config pair of event
+        inline void FillPerfEventAttr(PerfEvent event, perf_event_attr& attr) noexcept {
+            auto cache = [](std::uint64_t id) {
+                return id | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            };
+            switch (event) {
+                case PerfEvent::kCycles:
+                    attr.type = PERF_TYPE_HARDWARE;
+                    attr.config = PERF_COUNT_HW_CPU_CYCLES;
+                    break;
+                case PerfEvent::kInstructions:
+                    attr.type = PERF_TYPE_HARDWARE;
+                    attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+                    break;
+                case PerfEvent::kL1dMisses:
+                    attr.type = PERF_TYPE_HW_CACHE;
+                    attr.config = cache(PERF_COUNT_HW_CACHE_L1D);
+                    break;
+                case PerfEvent::kLlcMisses:
+                    attr.type = PERF_TYPE_HW_CACHE;
+                    attr.config = cache(PERF_COUNT_HW_CACHE_LL);
+                    break;
+                case PerfEvent::kBranchMisses:
+                    attr.type = PERF_TYPE_HARDWARE;
+                    attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+                    break;
+                case PerfEvent::kDtlbMisses:
+                    attr.type = PERF_TYPE_HW_CACHE;
+                    attr.config = cache(PERF_COUNT_HW_CACHE_DTLB);
+                    break;
+            }
+        }
+    } // namespace details
+
+    /**
+     * @brief Group of hardware performance counters of calling thread
+     *
+     * Counters are opened with perf_event_open() and read from user space with RDPMC through
+     * the mmap'ed perf_event_mmap_page, so a read costs about as much as Rdtsc(). If the kernel
+     * does not allow user-space RDPMC (/sys/bus/event_source/devices/cpu/rdpmc), counters are
+     * read with read() syscall instead.
+     *
+     * Example usage:
+     * @code
+     * PerfCounters counters{};
+     * if (counters.Open()) {
+     *     auto result = benchmark.Run(code, settings, counters);
+     *     std::cout << "IPC: " << result.counters_.Ipc() << "\n";
+     * }
+     * @endcode
+     */
+    class PerfCounters {
+    public:
+        static constexpr std::size_t kMaxEvents = 8;
+
+        /// Default event set: cycles, instructions, L1D/LLC misses, branch misses, dTLB misses
+        PerfCounters() : PerfCounters({PerfEvent::kCycles, PerfEvent::kInstructions, PerfEvent::kL1dMisses,
+                                       PerfEvent::kLlcMisses, PerfEvent::kBranchMisses, PerfEvent::kDtlbMisses}) {}
+
+        /// @param events Events to count (at most kMaxEvents)
+        explicit PerfCounters(std::vector<PerfEvent> events) : events_{std::move(events)} {
+            if (events_.size() > kMaxEvents) {
+                std::cerr << "[Warning] Only " << kMaxEvents << " performance counters are supported" << std::endl;
+                events_.resize(kMaxEvents);
+            }
+        }
+
+        PerfCounters(const PerfCounters&) = delete;
+        PerfCounters& operator=(const PerfCounters&) = delete;
+
+        ~PerfCounters() { Close(); }
+
+        /// Open counters for calling thread
+        /// @return true if all events were opened
+        bool Open();
+
+        /// Close counters
+        void Close() noexcept;
+
+        /// Check if counters are open
+        [[nodiscard]] bool IsOpen() const noexcept { return opened_ != 0; }
+
+        /// Check if counters are read with RDPMC (false - read() fallback)
+        [[nodiscard]] bool IsRdpmcEnabled() const noexcept { return rdpmc_; }
+
+        /// Counted events
+        [[nodiscard]] const std::vector<PerfEvent>& Events() const noexcept { return events_; }
+
+        /**
+         * @brief Read current value of every counter
+         * @param values Output array with at least Events().size() elements
+         */
+        FORCE_INLINE void Read(std::uint64_t* values) noexcept {
+            if (LIKELY(rdpmc_)) {
+                for (std::size_t i = 0; i < opened_; ++i) {
+                    values[i] = ReadRdpmc(pages_[i]);
+                }
+            } else {
+                ReadSyscall(values);
+            }
+        }
+
+        /// Check that group was actually scheduled on PMU and not multiplexed
+        [[nodiscard]] bool IsScheduled() noexcept;
+
+    private:
+        static FORCE_INLINE std::uint64_t ReadRdpmc(const perf_event_mmap_page* page) noexcept {
+            std::uint64_t count;
+            std::uint32_t sequence;
+            do {
+                sequence = page->lock;
+                COMPILER_BARRIER();
+                const std::uint32_t index = page->index;
+                count = static_cast<std::uint64_t>(page->offset);
+                if (LIKELY(index != 0)) {
+                    const unsigned shift = 64 - page->pmc_width;
+                    auto pmc = static_cast<std::int64_t>(details::Rdpmc(index - 1) << shift) >> shift;
+                    count += static_cast<std::uint64_t>(pmc);
+                }
+                COMPILER_BARRIER();
+            } while (UNLIKELY(page->lock != sequence));
+            return count;
+        }
+
+        void ReadSyscall(std::uint64_t* values) noexcept;
+
+        std::vector<PerfEvent> events_{};
+        std::array<int, kMaxEvents> fds_{};
+        std::array<perf_event_mmap_page*, kMaxEvents> pages_{};
+        std::size_t opened_{0};
+        bool rdpmc_{false};
+    };
+
+
+    /// Hardware counter values of benchmark run
+    class CounterResult {
+    public:
+        /// Counted events (empty if counters were not used)
+        std::vector<PerfEvent> events_{};
+
+        /// Per-sample counts of empty code (StartTime/EndTime and read cost) subtracted from samples
+        std::vector<std::uint64_t> baseline_{};
+
+        /// Average count per invocation with baseline subtracted
+        std::vector<double> per_call_{};
+
+        /// Raw per-sample counts, row-major [sample][event] (filled if Settings::record_samples_ is set)
+        std::vector<std::uint64_t> samples_{};
+
+        /// False if counters were not opened or not scheduled on PMU during run
+        bool valid_{false};
+
+        /// Average count of event per invocation (0 if event was not counted)
+        [[nodiscard]] double PerCall(PerfEvent event) const noexcept {
+            for (std::size_t i = 0; i < events_.size(); ++i) {
+                if (events_[i] == event) {
+                    return per_call_[i];
+                }
+            }
+            return 0.0;
+        }
+
+        /// Instructions per core cycle (needs kInstructions and kCycles)
+        [[nodiscard]] double Ipc() const noexcept {
+            double cycles = PerCall(PerfEvent::kCycles);
+            return cycles > 0.0 ? PerCall(PerfEvent::kInstructions) / cycles : 0.0;
+        }
+    };
+
+
+    // Implementation
+    inline bool PerfCounters::Open() {
+        Close();
+        const long page_size = sysconf(_SC_PAGESIZE);
+        rdpmc_ = true;
+        for (std::size_t i = 0; i < events_.size(); ++i) {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            details::FillPerfEventAttr(events_[i], attr);
+            attr.disabled = i == 0 ? 1 : 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            const int group_fd = i == 0 ? -1 : fds_[0];
+            const int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+            if (fd == -1) {
+                std::cerr << "[Warning] Failed to open performance counter " << ToString(events_[i])
+                          << ": " << std::strerror(errno) << std::endl;
+                Close();
+                return false;
+            }
+            fds_[i] = fd;
+            ++opened_;
+
+            void* page = mmap(nullptr, static_cast<std::size_t>(page_size), PROT_READ, MAP_SHARED, fd, 0);
+            if (page == MAP_FAILED) {
+                pages_[i] = nullptr;
+                rdpmc_ = false;
+            } else {
+                pages_[i] = static_cast<perf_event_mmap_page*>(page);
+                rdpmc_ = rdpmc_ && pages_[i]->cap_user_rdpmc;
+            }
+        }
+        if (opened_ == 0) {
+            return false;
+        }
+        if (!rdpmc_) {
+            std::cerr << "[Warning] User-space RDPMC is not available - performance counters are read with read()" << std::endl;
+        }
+
+        ioctl(fds_[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        return true;
+    }
+
+    inline void PerfCounters::Close() noexcept {
+        const long page_size = sysconf(_SC_PAGESIZE);
+        for (std::size_t i = 0; i < opened_; ++i) {
+            if (pages_[i] != nullptr) {
+                munmap(pages_[i], static_cast<std::size_t>(page_size));
+                pages_[i] = nullptr;
+            }
+            close(fds_[i]);
+        }
+        opened_ = 0;
+        rdpmc_ = false;
+    }
+
+    inline void PerfCounters::ReadSyscall(std::uint64_t* values) noexcept {
+        // Layout of PERF_FORMAT_GROUP: nr, time_enabled, time_running, values[nr]
+        std::uint64_t buffer[3 + kMaxEvents]{};
+        if (opened_ == 0 || read(fds_[0], buffer, sizeof(buffer)) <= 0) {
+            std::fill(values, values + events_.size(), 0);
+            return;
+        }
+        for (std::size_t i = 0; i < opened_; ++i) {
+            values[i] = buffer[3 + i];
+        }
+    }
+
+    inline bool PerfCounters::IsScheduled() noexcept {
+        std::uint64_t buffer[3 + kMaxEvents]{};
+        if (opened_ == 0 || read(fds_[0], buffer, sizeof(buffer)) <= 0) {
+            return false;
+        }
+        return buffer[2] > 0 && buffer[1] == buffer[2];
+    }
+
+} // namespace benchmarking
@@ -0,0 +1,353 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tsc_cpu.h"
+#include "utils/compiler.h"
+#include "utils/types.h"
+
+namespace benchmarking {
+
+    /**
+     * @brief Log-linear histogram bucketing (HDR-style)
+     *
+     * Values below kSubBuckets get one bucket each, every further power of two is split into
+     * kSubBuckets linear buckets, so relative bucket width stays below 1 / kSubBuckets.
+     */
+    class LogLinearBuckets {
+    public:
+        static constexpr unsigned kSubBucketBits = 4;
+        static constexpr std::size_t kSubBuckets = std::size_t{1} << kSubBucketBits;
+        static constexpr std::size_t kBucketsNumber = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+        /// Bucket of value
+        static FORCE_INLINE std::size_t Index(TimePoint value) noexcept {
+            if (value < kSubBuckets) {
+                return static_cast<std::size_t>(value);
+            }
+            const unsigned magnitude = 63u - static_cast<unsigned>(__builtin_clzll(value));
+            const unsigned shift = magnitude - kSubBucketBits;
+            return (shift + 1) * kSubBuckets + static_cast<std::size_t>((value >> shift) & (kSubBuckets - 1));
+        }
+
+        /// Smallest value of bucket
+        static constexpr TimePoint LowerBound(std::size_t index) noexcept {
+            if (index < kSubBuckets) {
+                return index;
+            }
+            const std::size_t shift = index / kSubBuckets - 1;
+            return (kSubBuckets | (index % kSubBuckets)) << shift;
+        }
+
+        /// Largest value of bucket
+        static constexpr TimePoint UpperBound(std::size_t index) noexcept {
+            if (index < kSubBuckets) {
+                return index;
+            }
+            const std::size_t shift = index / kSubBuckets - 1;
+            return LowerBound(index) + ((TimePoint{1} << shift) - 1);
+        }
+    };
+
+    /// Point-in-time copy of probe histogram (merged over threads)
+    class HistogramSnapshot {
+    public:
+        /// Probe name
+        std::string name_{};
+
+        /// Sample count per LogLinearBuckets bucket
+        std::vector<std::uint64_t> counts_ = std::vector<std::uint64_t>(LogLinearBuckets::kBucketsNumber, 0);
+
+        /// Number of samples
+        std::uint64_t count_{0};
+
+        /// Sum of all samples in TSC ticks
+        std::uint64_t sum_{0};
+
+        /// Largest sample in TSC ticks
+        TimePoint max_{0};
+
+        /// Mean in TSC ticks
+        [[nodiscard]] double Mean() const noexcept {
+            return count_ == 0 ? 0.0 : static_cast<double>(sum_) / static_cast<double>(count_);
+        }
+
+        /// Upper bound of bucket containing quantile q (0..1) in TSC ticks
+        [[nodiscard]] TimePoint Quantile(double q) const noexcept {
+            if (count_ == 0) {
+                return 0;
+            }
+            const auto rank = static_cast<std::uint64_t>(std::clamp(q, 0.0, 1.0) * static_cast<double>(count_ - 1));
+            std::uint64_t cumulative = 0;
+            for (std::size_t i = 0; i < counts_.size(); ++i) {
+                cumulative += counts_[i];
+                if (cumulative > rank) {
+                    return std::min(LogLinearBuckets::UpperBound(i), max_);
+                }
+            }
+            return max_;
+        }
+
+        /// Add counts of another snapshot
+        HistogramSnapshot& operator+=(const HistogramSnapshot& other) noexcept {
+            for (std::size_t i = 0; i < counts_.size(); ++i) {
+                counts_[i] += other.counts_[i];
+            }
+            count_ += other.count_;
+            sum_ += other.sum_;
+            max_ = std::max(max_, other.max_);
+            return *this;
+        }
+    };
+
+    namespace details {
+        /**
+         * @brief Single-writer histogram of one probe on one thread
+         *
+         * Owner thread updates counters with relaxed load + store (no locked instructions);
+         * readers see every counter monotonically increasing, possibly a few samples behind.
+         */
+        class ProbeHistogram {
+        public:
+            FORCE_INLINE void Record(TimePoint value) noexcept {
+                Increment(counts_[LogLinearBuckets::Index(value)], 1);
+                Increment(count_, 1);
+                Increment(sum_, value);
+                if (UNLIKELY(value > max_.load(std::memory_order_relaxed))) {
+                    max_.store(value, std::memory_order_relaxed);
+                }
+            }
+
+            /// Add current counts to snapshot (safe from any thread)
+            void AddTo(HistogramSnapshot& snapshot) const noexcept {
+                for (std::size_t i = 0; i < counts_.size(); ++i) {
+                    snapshot.counts_[i] += counts_[i].load(std::memory_order_relaxed);
+                }
+                snapshot.count_ += count_.load(std::memory_order_relaxed);
+                snapshot.sum_ += sum_.load(std::memory_order_relaxed);
+                snapshot.max_ = std::max(snapshot.max_, max_.load(std::memory_order_relaxed));
+            }
+
+        private:
+            static FORCE_INLINE void Increment(std::atomic<std::uint64_t>& counter, std::uint64_t value) noexcept {
+                counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+            }
+
+            std::array<std::atomic<std::uint64_t>, LogLinearBuckets::kBucketsNumber> counts_{};
+            alignas(kCacheLineSize) std::atomic<std::uint64_t> count_{0};
+            std::atomic<std::uint64_t> sum_{0};
+            std::atomic<TimePoint> max_{0};
+        };
+    } // namespace details
+
+    /**
+     * @brief Process-wide registry of probe sites and per-thread histograms
+     *
+     * The hot path only touches thread-local memory; the mutex is taken when a thread records
+     * a site for the first time, on thread exit and by Snapshot().
+     */
+    class ProbeRegistry {
+    public:
+        /// Maximal number of distinct TSC_PROBE sites
+        static constexpr std::size_t kMaxSites = 256;
+
+        static ProbeRegistry& Instance() {
+            static ProbeRegistry registry{};
+            return registry;
+        }
+
+        /// Register probe site (called once per site from static initialization)
+        std::size_t RegisterSite(const char* name) {
+            std::lock_guard<std::mutex> lock{mutex_};
+            if (names_.size() >= kMaxSites) {
+                std::cerr << "[Warning] More than " << kMaxSites << " probe sites - probe " << name << " is ignored" << std::endl;
+                return kMaxSites;
+            }
+            names_.emplace_back(name);
+            retired_.emplace_back();
+            retired_.back().name_ = name;
+            return names_.size() - 1;
+        }
+
+        /// Record sample of site on calling thread
+        FORCE_INLINE void Record(std::size_t site, TimePoint value) noexcept {
+            ThreadProbes& probes = Local();
+            details::ProbeHistogram* histogram = probes.histograms_[site].load(std::memory_order_relaxed);
+            if (UNLIKELY(histogram == nullptr)) {
+                histogram = CreateHistogram(probes, site);
+            }
+            histogram->Record(value);
+        }
+
+        /// Merge histograms of all live and exited threads per site
+        [[nodiscard]] std::vector<HistogramSnapshot> Snapshot() {
+            std::lock_guard<std::mutex> lock{mutex_};
+            std::vector<HistogramSnapshot> snapshots = retired_;
+            for (const ThreadProbes* probes : threads_) {
+                for (std::size_t site = 0; site < snapshots.size(); ++site) {
+                    if (const details::ProbeHistogram* histogram = probes->histograms_[site].load(std::memory_order_acquire)) {
+                        histogram->AddTo(snapshots[site]);
+                    }
+                }
+            }
+            return snapshots;
+        }
+
+    private:
+        /// Histograms of one thread (index - site id, kMaxSites slot absorbs overflowing sites)
+        class ThreadProbes {
+        public:
+            explicit ThreadProbes(ProbeRegistry& registry) : registry_{registry} {}
+
+            ~ThreadProbes() { registry_.Retire(*this); }
+
+            ProbeRegistry& registry_;
+            std::array<std::atomic<details::ProbeHistogram*>, kMaxSites + 1> histograms_{};
+            std::vector<std::unique_ptr<details::ProbeHistogram>> owned_{};
+        };
+
+        ProbeRegistry() = default;
+
+        static FORCE_INLINE ThreadProbes& Local() {
+            thread_local ThreadProbes probes{Instance()};
+            return probes;
+        }
+
+        details::ProbeHistogram* CreateHistogram(ThreadProbes& probes, std::size_t site) {
+            std::lock_guard<std::mutex> lock{mutex_};
+            if (probes.owned_.empty()) {
+                threads_.push_back(&probes);
+            }
+            probes.owned_.push_back(std::make_unique<details::ProbeHistogram>());
+            probes.histograms_[site].store(probes.owned_.back().get(), std::memory_order_release);
+            return probes.owned_.back().get();
+        }
+
+        /// Fold histograms of exiting thread into retired_ so that samples survive it
+        void Retire(ThreadProbes& probes) {
+            std::lock_guard<std::mutex> lock{mutex_};
+            for (std::size_t site = 0; site < retired_.size(); ++site) {
+                if (const details::ProbeHistogram* histogram = probes.histograms_[site].load(std::memory_order_relaxed)) {
+                    histogram->AddTo(retired_[site]);
+                }
+            }
+            threads_.erase(std::remove(threads_.begin(), threads_.end(), &probes), threads_.end());
+        }
+
+        std::mutex mutex_{};
+        std::vector<std::string> names_{};
+        std::vector<HistogramSnapshot> retired_{};
+        std::vector<ThreadProbes*> threads_{};
+    };
+
+    /// Probe site created by TSC_PROBE
+    class ProbeSite {
+    public:
+        explicit ProbeSite(const char* name) : id_{ProbeRegistry::Instance().RegisterSite(name)} {}
+
+        [[nodiscard]] std::size_t Id() const noexcept { return id_; }
+
+    private:
+        std::size_t id_;
+    };
+
+    /// Records unfenced Rdtsc() delta between construction and destruction
+    class ScopedProbe {
+    public:
+        explicit FORCE_INLINE ScopedProbe(const ProbeSite& site) noexcept : site_{site.Id()}, start_{details::Rdtsc()} {}
+
+        ScopedProbe(const ScopedProbe&) = delete;
+        ScopedProbe& operator=(const ScopedProbe&) = delete;
+
+        FORCE_INLINE ~ScopedProbe() {
+            ProbeRegistry::Instance().Record(site_, details::Rdtsc() - start_);
+        }
+
+    private:
+        std::size_t site_;
+        TimePoint start_;
+    };
+
+    /**
+     * @brief Background thread passing merged probe snapshots to callback at fixed interval
+     *
+     * Example usage:
+     * @code
+     * ProbeReporter reporter{};
+     * reporter.Start(std::chrono::seconds{10}, [](const std::vector<HistogramSnapshot>& snapshots) {
+     *     for (const auto& snapshot : snapshots) { log(snapshot.name_, snapshot.Quantile(0.99)); }
+     * });
+     * @endcode
+     */
+    class ProbeReporter {
+    public:
+        using Callback = std::function<void(const std::vector<HistogramSnapshot>&)>;
+
+        ProbeReporter() = default;
+        ProbeReporter(const ProbeReporter&) = delete;
+        ProbeReporter& operator=(const ProbeReporter&) = delete;
+
+        ~ProbeReporter() { Stop(); }
+
+        /// Start reporter thread (restarts it if already running)
+        void Start(std::chrono::milliseconds interval, Callback callback) {
+            Stop();
+            stop_ = false;
+            thread_ = std::thread{[this, interval, callback = std::move(callback)]() {
+                std::unique_lock<std::mutex> lock{mutex_};
+                while (!condition_.wait_for(lock, interval, [this]() { return stop_; })) {
+                    lock.unlock();
+                    callback(ProbeRegistry::Instance().Snapshot());
+                    lock.lock();
+                }
+            }};
+        }
+
+        /// Stop reporter thread
+        void Stop() {
+            {
+                std::lock_guard<std::mutex> lock{mutex_};
+                stop_ = true;
+            }
+            condition_.notify_all();
+            if (thread_.joinable()) {
+                thread_.join();
+            }
+        }
+
+    private:
+        std::mutex mutex_{};
+        std::condition_variable condition_{};
+        bool stop_{false};
+        std::thread thread_{};
+    };
+
+} // namespace benchmarking
+
+#define TSC_PROBE_CONCAT_IMPL(a, b) a##b
+#define TSC_PROBE_CONCAT(a, b) TSC_PROBE_CONCAT_IMPL(a, b)
+
+/**
+ * @brief Record duration of enclosing scope into histogram of probe name
+ *
+ * Compiles to nothing if TSC_PROBES_DISABLED is defined.
+ */
+#ifndef TSC_PROBES_DISABLED
+    #define TSC_PROBE(name)                                                                                          \
+        static const ::benchmarking::ProbeSite TSC_PROBE_CONCAT(tsc_probe_site_, __LINE__){name};                \
+        const ::benchmarking::ScopedProbe TSC_PROBE_CONCAT(tsc_probe_, __LINE__){TSC_PROBE_CONCAT(tsc_probe_site_, __LINE__)}
+#else
+    #define TSC_PROBE(name) static_cast<void>(0)
+#endif
@@ -0,0 +1,375 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <regex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "tsc_benchmark.h"
+#include "tsc_export.h"
+
+/// Benchmark type shared by all registered benchmarks (define before including to change barrier/migration check)
+#ifndef TSC_SUITE_BENCHMARK_TYPE
+#define TSC_SUITE_BENCHMARK_TYPE ::benchmarking::TSCBenchmarking<false, ::benchmarking::Barrier::kOneCpuId>
+#endif
+
+namespace benchmarking {
+
+    using SuiteBenchmark = TSC_SUITE_BENCHMARK_TYPE;
+
+    /**
+     * @brief Process-wide list of benchmarks registered with TSC_BENCHMARK
+     *
+     * Registration happens during static initialization, so entries of all translation units
+     * linked into binary are available in main().
+     */
+    class BenchmarkRegistry {
+    public:
+        /// Benchmark body - runs code with shared initialized benchmark and suite settings
+        using Function = SuiteBenchmark::Result (*)(SuiteBenchmark& benchmark, const SuiteBenchmark::Settings& settings);
+
+        /// Registered benchmark
+        class Entry {
+        public:
+            /// Unique benchmark name
+            std::string name_{};
+
+            /// Benchmark body
+            Function function_{nullptr};
+        };
+
+        /// Registry instance
+        static BenchmarkRegistry& Instance() {
+            static BenchmarkRegistry registry{};
+            return registry;
+        }
+
+        /**
+         * @brief Register benchmark
+         * @param name Unique benchmark name
+         * @param function Benchmark body
+         * @return true if benchmark was registered (false on duplicate name)
+         */
+        bool Register(std::string name, Function function) {
+            auto same_name = [&name](const Entry& entry) { return entry.name_ == name; };
+            if (std::any_of(entries_.begin(), entries_.end(), same_name)) {
+                std::cerr << "[Warning] Benchmark " << name << " is already registered" << std::endl;
+                return false;
+            }
+            entries_.push_back(Entry{std::move(name), function});
+            return true;
+        }
+
+        /// Registered benchmarks in registration order
+        [[nodiscard]] const std::vector<Entry>& Entries() const noexcept { return entries_; }
+
+    private:
+        BenchmarkRegistry() = default;
+
+        std::vector<Entry> entries_{};
+    };
+
+    /// Command line options of suite runner
+    class SuiteOptions {
+    public:
+        /// ECMAScript regex matched against whole benchmark name
+        std::string filter_{".*"};
+
+        /// Number of times every benchmark is run
+        std::size_t repetitions_{1};
+
+        /// Run benchmarks in random order (reshuffled every repetition)
+        bool shuffle_{false};
+
+        /// Seed of shuffle
+        std::uint64_t seed_{std::random_device{}()};
+
+        /// Print matching benchmark names and exit
+        bool list_{false};
+
+        /// Write <prefix>.json, <prefix>.csv and <prefix>.samples.csv (empty - no export)
+        std::string out_prefix_{};
+
+        /// Samples CSV of baseline run to compare against (empty - no comparison)
+        std::string baseline_path_{};
+
+        /// Significance level of baseline comparison
+        double alpha_{0.01};
+
+        /// Minimal relative change of median reported as regression
+        double threshold_{0.02};
+
+        /// Re-runs of benchmark whose result is flagged noisy (Result::noisy_)
+        std::size_t noisy_retries_{2};
+
+        /// Settings passed to every benchmark (record_samples_ is on so p50/p99 are reported)
+        SuiteBenchmark::Settings settings_{[]() {
+            SuiteBenchmark::Settings settings{};
+            settings.cycles_number_ = 1000;
+            settings.cache_warmup_cycles_number_ = 100;
+            settings.record_samples_ = true;
+            settings.overhead_correction_ = OverheadCorrection::kSubtractMin;
+            return settings;
+        }()};
+
+        /// Print usage of runner
+        static void PrintUsage(const char* program) {
+            std::cerr << "Usage: " << program << " [--filter=REGEX] [--repetitions=N] [--shuffle[=SEED]]"
+                      << " [--cpu=N] [--cycles=N] [--list] [--out=PREFIX] [--baseline=SAMPLES_CSV]"
+                      << " [--alpha=P] [--threshold=FRACTION] [--max-noise=FRACTION] [--noisy-retries=N]\n";
+        }
+
+        /**
+         * @brief Parse command line
+         * @param argc Number of arguments
+         * @param argv Arguments
+         * @param options Parsed options
+         * @return false on unknown argument, malformed numeric value or --help
+         */
+        static bool Parse(int argc, char** argv, SuiteOptions& options) {
+            for (int i = 1; i < argc; ++i) {
+                std::string arg = argv[i];
+                auto value = [&arg]() { return arg.substr(arg.find('=') + 1); };
+                try {
+                    if (arg.rfind("--filter=", 0) == 0) {
+                        options.filter_ = value();
+                    } else if (arg.rfind("--repetitions=", 0) == 0) {
+                        options.repetitions_ = std::max<std::size_t>(std::stoul(value()), 1);
+                    } else if (arg == "--shuffle") {
+                        options.shuffle_ = true;
+                    } else if (arg.rfind("--shuffle=", 0) == 0) {
+                        options.shuffle_ = true;
+                        options.seed_ = std::stoull(value());
+                    } else if (arg.rfind("--cpu=", 0) == 0) {
+                        options.settings_.cpu_ = std::stoi(value());
+                    } else if (arg.rfind("--cycles=", 0) == 0) {
+                        options.settings_.cycles_number_ = std::stoul(value());
+                    } else if (arg == "--list") {
+                        options.list_ = true;
+                    } else if (arg.rfind("--out=", 0) == 0) {
+                        options.out_prefix_ = value();
+                    } else if (arg.rfind("--baseline=", 0) == 0) {
+                        options.baseline_path_ = value();
+                    } else if (arg.rfind("--alpha=", 0) == 0) {
+                        options.alpha_ = std::stod(value());
+                    } else if (arg.rfind("--threshold=", 0) == 0) {
+                        options.threshold_ = std::stod(value());
+                    } else if (arg.rfind("--max-noise=", 0) == 0) {
+                        options.settings_.max_noise_score_ = std::stod(value());
+                    } else if (arg.rfind("--noisy-retries=", 0) == 0) {
+                        options.noisy_retries_ = std::stoul(value());
+                    } else {
+                        return false;
+                    }
+                } catch (const std::logic_error&) {
+                    // std::stoul/stoi/stod throw invalid_argument or out_of_range on malformed numbers
+                    std::cerr << "[Warning] Invalid value of argument " << arg << std::endl;
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    /// Result of one benchmark repetition
+    class SuiteRecord {
+    public:
+        /// Benchmark name
+        std::string name_{};
+
+        /// 0-based repetition index
+        std::size_t repetition_{0};
+
+        /// Benchmark result
+        SuiteBenchmark::Result result_{};
+    };
+
+    /**
+     * @brief Run registered benchmarks matching options
+     *
+     * Benchmark is initialized once (RT scheduling, overhead measurement, TSC calibration)
+     * and shared by all benchmarks, so every result uses the same calibration.
+     *
+     * @param options Runner options
+     * @param benchmark Benchmark initialized by caller
+     * @param out Stream for per-benchmark report lines
+     * @return Results in execution order
+     */
+    inline std::vector<SuiteRecord> RunSuite(const SuiteOptions& options, SuiteBenchmark& benchmark, std::ostream& out) {
+        const std::regex filter{options.filter_};
+        std::vector<const BenchmarkRegistry::Entry*> selected;
+        for (const BenchmarkRegistry::Entry& entry : BenchmarkRegistry::Instance().Entries()) {
+            if (std::regex_match(entry.name_, filter)) {
+                selected.push_back(&entry);
+            }
+        }
+
+        const TSCCalibration& calibration = benchmark.GetCalibration();
+        auto nanos = [&calibration](TimePoint ticks) { return calibration.ToFractionalNanos(static_cast<double>(ticks)).count(); };
+
+        std::size_t name_width = 9;
+        for (const BenchmarkRegistry::Entry* entry : selected) {
+            name_width = std::max(name_width, entry->name_.size());
+        }
+        out << std::left << std::setw(static_cast<int>(name_width)) << "Benchmark" << std::right
+            << std::setw(5) << "Rep" << std::setw(10) << "Samples"
+            << std::setw(12) << "Mean ns" << std::setw(12) << "Median ns" << std::setw(12) << "p99 ns"
+            << std::setw(12) << "Op ns" << std::setw(10) << "Noise %" << '\n';
+
+        std::mt19937_64 random{options.seed_};
+        std::vector<SuiteRecord> records;
+        records.reserve(selected.size() * options.repetitions_);
+        for (std::size_t repetition = 0; repetition < options.repetitions_; ++repetition) {
+            if (options.shuffle_) {
+                std::shuffle(selected.begin(), selected.end(), random);
+            }
+            for (const BenchmarkRegistry::Entry* entry : selected) {
+                SuiteRecord record{entry->name_, repetition, entry->function_(benchmark, options.settings_)};
+                // Noisy results are rejected and re-measured, the last attempt is kept either way
+                for (std::size_t retry = 0; record.result_.noisy_ && retry < options.noisy_retries_; ++retry) {
+                    record.result_ = entry->function_(benchmark, options.settings_);
+                }
+                const SuiteBenchmark::Result& result = record.result_;
+                out << std::left << std::setw(static_cast<int>(name_width)) << record.name_ << std::right
+                    << std::setw(5) << repetition << std::setw(10) << result.samples_number_
+                    << std::fixed << std::setprecision(1)
+                    << std::setw(12) << nanos(result.corrected_time_)
+                    << std::setw(12) << nanos(result.corrected_distribution_.median_)
+                    << std::setw(12) << nanos(result.corrected_distribution_.p99_)
+                    << std::setw(12) << result.per_op_time_ns_.count()
+                    << std::setprecision(2) << std::setw(10) << result.noise_score_ * 100.0
+                    << (result.noisy_ ? " noisy" : "") << std::defaultfloat << std::setprecision(6) << '\n';
+                records.push_back(std::move(record));
+            }
+        }
+        return records;
+    }
+
+    /**
+     * @brief Report comparison of current run against baseline
+     * @param comparisons Comparisons from CompareToBaseline()
+     * @param calibration TSC calibration of current run
+     * @param out Output stream
+     * @return Number of regressions
+     */
+    inline std::size_t WriteBaselineReport(const std::vector<BaselineComparison>& comparisons,
+                                           const TSCCalibration& calibration, std::ostream& out) {
+        auto nanos = [&calibration](TimePoint ticks) { return calibration.ToFractionalNanos(static_cast<double>(ticks)).count(); };
+        std::size_t regressions = 0;
+        out << "\nBaseline comparison (Mann-Whitney U)\n";
+        for (const BaselineComparison& comparison : comparisons) {
+            const char* verdict = comparison.regression_ ? "REGRESSION" : comparison.improvement_ ? "improvement" : "ok";
+            out << "  " << comparison.name_ << ": " << std::fixed << std::setprecision(1)
+                << nanos(comparison.baseline_median_) << " -> " << nanos(comparison.current_median_) << " ns ("
+                << std::showpos << comparison.relative_change_ * 100.0 << std::noshowpos << "%), p="
+                << std::defaultfloat << std::setprecision(3) << comparison.test_.p_value_ << std::setprecision(6)
+                << ' ' << verdict << '\n';
+            regressions += comparison.regression_ ? 1 : 0;
+        }
+        return regressions;
+    }
+
+    /**
+     * @brief Entry point of suite binary (see TSC_BENCHMARK_MAIN)
+     * @param argc Number of arguments
+     * @param argv Arguments
+     * @return Process exit code
+     */
+    inline int RunSuiteMain(int argc, char** argv) {
+        SuiteOptions options{};
+        if (!SuiteOptions::Parse(argc, argv, options)) {
+            SuiteOptions::PrintUsage(argv[0]);
+            return argc > 1 && std::string{argv[argc - 1]} == "--help" ? 0 : 1;
+        }
+
+        try {
+            std::regex{options.filter_};
+        } catch (const std::regex_error&) {
+            std::cerr << "[Warning] Invalid filter regex: " << options.filter_ << std::endl;
+            return 1;
+        }
+
+        if (options.list_) {
+            const std::regex filter{options.filter_};
+            for (const BenchmarkRegistry::Entry& entry : BenchmarkRegistry::Instance().Entries()) {
+                if (std::regex_match(entry.name_, filter)) {
+                    std::cout << entry.name_ << '\n';
+                }
+            }
+            return 0;
+        }
+
+        SuiteBenchmark benchmark{};
+        benchmark.Initialize(options.settings_);
+        if (options.shuffle_) {
+            std::cout << "[Info] Shuffle seed " << options.seed_ << std::endl;
+        }
+        std::vector<SuiteRecord> records = RunSuite(options, benchmark, std::cout);
+
+        ResultExporter exporter{HostInfo::Collect(benchmark.GetCalibration(), SuiteBenchmark::kBarrier,
+                                                  SuiteBenchmark::kCheckCpuMigration)};
+        for (const SuiteRecord& record : records) {
+            exporter.Add(record.name_, record.result_, record.repetition_);
+        }
+        if (!options.out_prefix_.empty()) {
+            std::ofstream json{options.out_prefix_ + ".json"}, csv{options.out_prefix_ + ".csv"};
+            std::ofstream samples{options.out_prefix_ + ".samples.csv"};
+            if (!json || !csv || !samples) {
+                std::cerr << "[Warning] Failed to open output files " << options.out_prefix_ << ".*" << std::endl;
+                return 1;
+            }
+            exporter.WriteJson(json);
+            exporter.WriteCsv(csv);
+            exporter.WriteSamplesCsv(samples);
+        }
+
+        if (!options.baseline_path_.empty()) {
+            std::ifstream in{options.baseline_path_};
+            std::map<std::string, std::vector<TimePoint>> baseline;
+            if (!in || !LoadSamplesCsv(in, baseline)) {
+                std::cerr << "[Warning] Failed to load baseline " << options.baseline_path_ << std::endl;
+                return 1;
+            }
+            auto comparisons = CompareToBaseline(baseline, exporter.SamplesByName(), options.alpha_, options.threshold_);
+            if (WriteBaselineReport(comparisons, benchmark.GetCalibration(), std::cout) > 0) {
+                return 2;
+            }
+        }
+        return 0;
+    }
+
+} // namespace benchmarking
+
+/**
+ * @brief Define and register benchmark
+ *
+ * Body receives `benchmark` (shared, already initialized) and `settings` (suite settings)
+ * and returns Result of one of benchmark's Run*() methods:
+ * @code
+ * TSC_BENCHMARK(vector_push_back) {
+ *     std::vector<int> data;
+ *     data.reserve(64);
+ *     return benchmark.Run([&data]() { data.push_back(1); data.clear(); }, settings);
+ * }
+ * @endcode
+ */
+#define TSC_BENCHMARK(name)                                                                                     \
+    static ::benchmarking::SuiteBenchmark::Result TscBenchmark_##name(                                          \
+            ::benchmarking::SuiteBenchmark& benchmark, const ::benchmarking::SuiteBenchmark::Settings& settings); \
+    [[maybe_unused]] static const bool kTscBenchmarkRegistered_##name =                                        \
+            ::benchmarking::BenchmarkRegistry::Instance().Register(#name, TscBenchmark_##name);                 \
+    static ::benchmarking::SuiteBenchmark::Result TscBenchmark_##name(                                          \
+            [[maybe_unused]] ::benchmarking::SuiteBenchmark& benchmark,                                         \
+            [[maybe_unused]] const ::benchmarking::SuiteBenchmark::Settings& settings)
+
+/// Define main() that runs registered benchmarks (see SuiteOptions for command line)
+#define TSC_BENCHMARK_MAIN()                                \
+    int main(int argc, char** argv) {                       \
+        return ::benchmarking::RunSuiteMain(argc, argv);    \
+    }
@@ -0,0 +1,256 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "tsc_export.h"
+#include "utils/compiler.h"
+#include "utils/mapped_file.h"
+#include "utils/types.h"
+
+namespace benchmarking {
+
+    /// Fixed-size header of binary sample file (little-endian, native layout)
+    class SampleFileHeader {
+    public:
+        static constexpr char kMagic[8] = {'T', 'S', 'C', 'S', 'A', 'M', 'P', 'L'};
+        static constexpr std::uint32_t kVersion = 1;
+
+        char magic_[8]{};
+        std::uint32_t version_{kVersion};
+
+        /// CPU core samples were taken on
+        std::int32_t cpu_{0};
+
+        /// Calibrated TSC frequency in Hz (0 - uncalibrated)
+        double tsc_hz_{0.0};
+
+        /// Number of samples (written by SampleWriter::Close())
+        std::uint64_t samples_number_{0};
+
+        /// CalibrationSource of tsc_hz_
+        std::uint8_t calibration_source_{0};
+
+        /// Barrier of benchmark clock
+        std::uint8_t barrier_{0};
+
+        /// CPU migration check of benchmark
+        std::uint8_t check_cpu_migration_{0};
+
+        std::uint8_t reserved_[5]{};
+
+        /// Benchmark name (NUL-terminated, truncated)
+        char name_[64]{};
+
+        /// CPU brand string (NUL-terminated)
+        char cpu_brand_[64]{};
+    };
+    static_assert(sizeof(SampleFileHeader) == 168, "Sample file header layout changed");
+
+    namespace details {
+        /// Map signed delta to unsigned so that small magnitudes get short varints
+        FORCE_INLINE std::uint64_t ZigZagEncode(std::int64_t value) noexcept {
+            return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+        }
+
+        FORCE_INLINE std::int64_t ZigZagDecode(std::uint64_t value) noexcept {
+            return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+        }
+
+        /// Write LEB128 varint (at most 10 bytes), return bytes written
+        FORCE_INLINE std::size_t EncodeVarint(std::uint64_t value, std::uint8_t* out) noexcept {
+            std::size_t size = 0;
+            while (value >= 0x80) {
+                out[size++] = static_cast<std::uint8_t>(value | 0x80);
+                value >>= 7;
+            }
+            out[size++] = static_cast<std::uint8_t>(value);
+            return size;
+        }
+
+        /// Read LEB128 varint, return bytes read (0 if input ends inside varint)
+        FORCE_INLINE std::size_t DecodeVarint(const std::uint8_t* in, const std::uint8_t* end, std::uint64_t& value) noexcept {
+            value = 0;
+            for (std::size_t i = 0, shift = 0; in + i < end && shift < 64; ++i, shift += 7) {
+                value |= static_cast<std::uint64_t>(in[i] & 0x7F) << shift;
+                if ((in[i] & 0x80) == 0) {
+                    return i + 1;
+                }
+            }
+            return 0;
+        }
+    } // namespace details
+
+    /**
+     * @brief Streaming writer of delta + zigzag varint encoded samples into memory-mapped file
+     *
+     * Consecutive samples of one benchmark differ by a few ticks, so most samples take 1-2 bytes
+     * instead of 8 (or ~10 in CSV). Samples can be appended incrementally, e.g. after every run
+     * of a long series:
+     * @code
+     * SampleWriter writer{};
+     * writer.Create("push_back.tscs", HostInfo::Collect(calibration, Benchmark::kBarrier, false), "push_back", 0);
+     * for (int i = 0; i < 1000; ++i) {
+     *     writer.Append(benchmark.Run(code, settings).samples_);
+     * }
+     * writer.Close();
+     * @endcode
+     */
+    class SampleWriter {
+    public:
+        SampleWriter() = default;
+        SampleWriter(const SampleWriter&) = delete;
+        SampleWriter& operator=(const SampleWriter&) = delete;
+
+        ~SampleWriter() { Close(); }
+
+        /**
+         * @brief Create sample file
+         * @param path File path
+         * @param host Calibration, barrier and CPU metadata stored in header
+         * @param name Benchmark name
+         * @param cpu CPU core samples are taken on
+         * @return false if file could not be created
+         */
+        bool Create(const std::string& path, const HostInfo& host, const std::string& name, int cpu) {
+            Close();
+            if (!file_.Create(path)) {
+                return false;
+            }
+            std::memcpy(header_.magic_, SampleFileHeader::kMagic, sizeof(header_.magic_));
+            header_.cpu_ = cpu;
+            header_.tsc_hz_ = host.tsc_hz_;
+            header_.calibration_source_ = static_cast<std::uint8_t>(host.calibration_source_);
+            header_.barrier_ = static_cast<std::uint8_t>(host.barrier_);
+            header_.check_cpu_migration_ = host.check_cpu_migration_ ? 1 : 0;
+            name.copy(header_.name_, sizeof(header_.name_) - 1);
+            host.cpu_brand_.copy(header_.cpu_brand_, sizeof(header_.cpu_brand_) - 1);
+            header_.samples_number_ = 0;
+            previous_ = 0;
+            return file_.Append(&header_, sizeof(header_));
+        }
+
+        /// Append one sample
+        bool Append(TimePoint sample) { return Append(std::span<const TimePoint>{&sample, 1}); }
+
+        /// Append samples in measurement order
+        bool Append(std::span<const TimePoint> samples) {
+            if (!file_.IsOpen()) {
+                return false;
+            }
+            std::array<std::uint8_t, kChunkSamples * kMaxVarintBytes> buffer{};
+            for (std::size_t first = 0; first < samples.size(); first += kChunkSamples) {
+                const std::size_t last = std::min(samples.size(), first + kChunkSamples);
+                std::size_t size = 0;
+                for (std::size_t i = first; i < last; ++i) {
+                    const auto delta = static_cast<std::int64_t>(samples[i] - previous_);
+                    size += details::EncodeVarint(details::ZigZagEncode(delta), buffer.data() + size);
+                    previous_ = samples[i];
+                }
+                if (!file_.Append(buffer.data(), size)) {
+                    return false;
+                }
+            }
+            header_.samples_number_ += samples.size();
+            return true;
+        }
+
+        /// Number of samples appended
+        [[nodiscard]] std::uint64_t SamplesNumber() const noexcept { return header_.samples_number_; }
+
+        /// Encoded size including header in bytes
+        [[nodiscard]] std::size_t Bytes() const noexcept { return file_.Size(); }
+
+        /// Write sample count into header and close file
+        void Close() {
+            if (file_.IsOpen()) {
+                std::memcpy(file_.Data(), &header_, sizeof(header_));
+                file_.Close();
+            }
+        }
+
+    private:
+        static constexpr std::size_t kChunkSamples = 512;
+        static constexpr std::size_t kMaxVarintBytes = 10;
+
+        details::MappedFile file_{};
+        SampleFileHeader header_{};
+        TimePoint previous_{0};
+    };
+
+    /**
+     * @brief Zero-copy reader of sample file
+     *
+     * Samples are decoded straight from the mapping, so histories larger than memory can be
+     * scanned with ForEach() without loading them.
+     */
+    class SampleReader {
+    public:
+        /// Map sample file
+        /// @return false if file is missing or not a sample file
+        bool Open(const std::string& path) {
+            if (!file_.OpenReadOnly(path)) {
+                return false;
+            }
+            if (file_.Size() < sizeof(SampleFileHeader)) {
+                std::cerr << "[Warning] " << path << " is too short to be a sample file" << std::endl;
+                return false;
+            }
+            std::memcpy(&header_, file_.Data(), sizeof(header_));
+            if (std::memcmp(header_.magic_, SampleFileHeader::kMagic, sizeof(header_.magic_)) != 0 ||
+                header_.version_ != SampleFileHeader::kVersion) {
+                std::cerr << "[Warning] " << path << " is not a sample file of this version" << std::endl;
+                return false;
+            }
+            return true;
+        }
+
+        [[nodiscard]] const SampleFileHeader& Header() const noexcept { return header_; }
+
+        /**
+         * @brief Decode samples in order
+         * @param callback Invoked with every sample
+         * @return Number of samples decoded (less than header count if file is truncated)
+         */
+        template<typename Callback>
+        std::uint64_t ForEach(Callback&& callback) const {
+            const auto* in = reinterpret_cast<const std::uint8_t*>(file_.Data()) + sizeof(SampleFileHeader);
+            const auto* end = reinterpret_cast<const std::uint8_t*>(file_.Data()) + file_.Size();
+            TimePoint sample = 0;
+            std::uint64_t decoded = 0;
+            while (decoded < header_.samples_number_) {
+                std::uint64_t value = 0;
+                const std::size_t size = details::DecodeVarint(in, end, value);
+                if (size == 0) {
+                    break;
+                }
+                in += size;
+                sample += static_cast<TimePoint>(details::ZigZagDecode(value));
+                callback(sample);
+                ++decoded;
+            }
+            return decoded;
+        }
+
+        /// Decode all samples into vector
+        [[nodiscard]] std::vector<TimePoint> ReadAll() const {
+            std::vector<TimePoint> samples;
+            // Header count is untrusted - every encoded sample takes at least one byte
+            const std::size_t encoded_bytes = file_.Size() - sizeof(SampleFileHeader);
+            samples.reserve(static_cast<std::size_t>(std::min<std::uint64_t>(header_.samples_number_, encoded_bytes)));
+            ForEach([&samples](TimePoint sample) { samples.push_back(sample); });
+            return samples;
+        }
+
+    private:
+        details::MappedFile file_{};
+        SampleFileHeader header_{};
+    };
+
+} // namespace benchmarking
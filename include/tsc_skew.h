@@ -0,0 +1,297 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "tsc_clock.h"
+#include "tsc_cpu.h"
+#include "tsc_statistics.h"
+#include "utils/affinity.h"
+#include "utils/compiler.h"
+#include "utils/spin_barrier.h"
+#include "utils/types.h"
+
+namespace benchmarking {
+
+    namespace details {
+        /// Result of cache-line ping-pong between two pinned cores
+        struct PingPongResult {
+            /// Minimal round trip (initiator -> responder -> initiator, clock overhead excluded) in TSC ticks
+            TimePoint min_round_trip_{0};
+
+            /// Minimal raw round trip t1 - t0 (clock overhead included) in TSC ticks - window of offset_
+            TimePoint raw_min_round_trip_{0};
+
+            /// Median round trip in TSC ticks
+            TimePoint median_round_trip_{0};
+
+            /// Minimal raw one-way latency (responder TSC - initiator TSC) in TSC ticks
+            std::int64_t min_one_way_{0};
+
+            /// Median raw one-way latency in TSC ticks
+            std::int64_t median_one_way_{0};
+
+            /// Responder TSC minus initiator TSC at the same instant (from tightest round trip)
+            std::int64_t offset_{0};
+
+            /// Socket/core decoded from TSC_AUX on initiator and responder
+            ::benchmarking::CpuId initiator_chip_{0}, initiator_core_{0};
+            ::benchmarking::CpuId responder_chip_{0}, responder_core_{0};
+
+            /// False if threads could not be pinned
+            bool valid_{false};
+        };
+
+        /**
+         * @brief Bounce one cache line between two pinned cores and timestamp every hop
+         *
+         * Initiator stamps t0 with TSCClock::StartTime() and publishes request, responder stamps tb
+         * with RDTSCP on arrival and replies, initiator stamps t1 with TSCClock::EndTime() on reply.
+         * Offset estimate tb - (t0 + t1) / 2 is taken from the round with smallest t1 - t0, its
+         * uncertainty is half of that raw round trip (raw_min_round_trip_). Raw one-way latency tb - t0 is only meaningful
+         * if TSCs of both cores are synchronized.
+         *
+         * @tparam BarrierType Barrier of initiator timestamps (kRdtscp keeps serialization outside the window)
+         * @param initiator_cpu CPU of initiating thread
+         * @param responder_cpu CPU of responding thread
+         * @param rounds Number of round trips
+         * @return Latency and offset estimates
+         */
+        template<Barrier BarrierType = Barrier::kRdtscp>
+        PingPongResult MeasurePingPong(int initiator_cpu, int responder_cpu, std::size_t rounds) {
+            constexpr std::size_t kOverheadCycles = 100;
+            struct alignas(kCacheLineSize) Line {
+                std::atomic<std::uint64_t> sequence_{0};
+                TimePoint responder_tsc_{0};
+            };
+            Line line{};
+
+            PingPongResult result{};
+            std::vector<TimePoint> starts(rounds), arrivals(rounds), ends(rounds);
+            TimePoint clock_overhead = ~TimePoint{0};
+            SpinBarrier barrier{2};
+            std::atomic<bool> pinned[2]{false, false};
+
+            std::thread responder([&]() {
+                pinned[1] = PinThread(responder_cpu, false);
+                barrier.ArriveAndWait();
+                if (!pinned[0] || !pinned[1]) {
+                    return;
+                }
+                for (std::uint64_t round = 0; round < rounds; ++round) {
+                    SpinUntil([&]() { return line.sequence_.load(std::memory_order_acquire) == 2 * round + 1; });
+                    TimePoint arrival = Rdtscp(result.responder_chip_, result.responder_core_);
+                    LFence();
+                    line.responder_tsc_ = arrival;
+                    line.sequence_.store(2 * round + 2, std::memory_order_release);
+                }
+            });
+
+            std::thread initiator([&]() {
+                pinned[0] = PinThread(initiator_cpu, false);
+                TSCClock<BarrierType> clock{};
+                for (std::size_t i = 0; i < kOverheadCycles; ++i) {
+                    // Same call pair as timed rounds (StartTime(aux) is RDTSCP-based)
+                    ::benchmarking::CpuId aux{0};
+                    TimePoint start = clock.StartTime(aux);
+                    TimePoint end = clock.EndTime();
+                    if (end > start) {
+                        clock_overhead = std::min(clock_overhead, end - start);
+                    }
+                }
+
+                barrier.ArriveAndWait();
+                if (!pinned[0] || !pinned[1]) {
+                    return;
+                }
+                for (std::uint64_t round = 0; round < rounds; ++round) {
+                    ::benchmarking::CpuId aux{0};
+                    TimePoint start = clock.StartTime(aux);
+                    line.sequence_.store(2 * round + 1, std::memory_order_release);
+                    SpinUntil([&]() { return line.sequence_.load(std::memory_order_acquire) == 2 * round + 2; });
+                    TimePoint end = clock.EndTime();
+                    result.initiator_chip_ = (aux >> 12) & 0xFFF;
+                    result.initiator_core_ = aux & 0xFFF;
+                    starts[round] = start;
+                    arrivals[round] = line.responder_tsc_;
+                    ends[round] = end;
+                }
+            });
+
+            initiator.join();
+            responder.join();
+            if (!pinned[0] || !pinned[1] || rounds == 0) {
+                return result;
+            }
+
+            std::vector<TimePoint> round_trips(rounds);
+            std::vector<std::int64_t> one_ways(rounds);
+            TimePoint best_round_trip = ~TimePoint{0};
+            for (std::size_t i = 0; i < rounds; ++i) {
+                round_trips[i] = ends[i] - starts[i];
+                one_ways[i] = static_cast<std::int64_t>(arrivals[i] - starts[i]);
+                if (round_trips[i] < best_round_trip) {
+                    best_round_trip = round_trips[i];
+                    result.offset_ = static_cast<std::int64_t>(arrivals[i] - starts[i]) -
+                                     static_cast<std::int64_t>(round_trips[i] / 2);
+                }
+            }
+
+            Distribution round_trip = ComputeDistribution(round_trips);
+            clock_overhead = std::min(clock_overhead, round_trip.min_);
+            result.raw_min_round_trip_ = round_trip.min_;
+            result.min_round_trip_ = round_trip.min_ - clock_overhead;
+            result.median_round_trip_ = round_trip.median_ - clock_overhead;
+            auto median = one_ways.begin() + static_cast<std::ptrdiff_t>(QuantileIndex(rounds, 0.5));
+            std::nth_element(one_ways.begin(), median, one_ways.end());
+            result.median_one_way_ = *median;
+            result.min_one_way_ = *std::min_element(one_ways.begin(), median + 1);
+            result.valid_ = true;
+            return result;
+        }
+    } // namespace details
+
+    /**
+     * @brief Pairwise TSC offset table between pinned cores
+     *
+     * Offsets are measured with cache-line ping-pong (details::MeasurePingPong) for every pair,
+     * so timestamps taken on one core can be translated into timebase of another and machines
+     * with unsynchronized TSCs can be detected.
+     *
+     * Example usage:
+     * @code
+     * auto table = TscSkewTable::Measure({0, 1, 2, 3});
+     * if (!table.IsSynchronized(100)) { ... }
+     * TimePoint local = table.Correct(producer_tsc, producer_cpu, consumer_cpu);
+     * @endcode
+     */
+    class TscSkewTable {
+    public:
+        static constexpr std::size_t kDefaultRounds = 1000;
+
+        /**
+         * @brief Measure offsets and round trips between all pairs of CPUs
+         * @param cpus CPU cores to include (negative and duplicate ids are skipped with a warning)
+         * @param rounds Ping-pong round trips per pair
+         * @return Offset table (pairs that failed to pin have Valid() == false)
+         */
+        static TscSkewTable Measure(const std::vector<int>& cpus, std::size_t rounds = kDefaultRounds);
+
+        /// Measure offsets between all online CPU cores
+        static TscSkewTable Measure() {
+            return Measure(details::GetCpuList());
+        }
+
+        /// CPU cores covered by table
+        [[nodiscard]] const std::vector<int>& Cpus() const noexcept { return cpus_; }
+
+        /// TSC of to_cpu minus TSC of from_cpu at the same instant in TSC ticks (0 if pair is not Valid())
+        [[nodiscard]] std::int64_t Offset(int from_cpu, int to_cpu) const noexcept {
+            return Valid(from_cpu, to_cpu) ? offsets_[Index(from_cpu, to_cpu)] : 0;
+        }
+
+        /// Minimal raw round trip between two cores in TSC ticks (offset uncertainty is half of it;
+        /// 0 if pair is not Valid())
+        [[nodiscard]] TimePoint RoundTrip(int from_cpu, int to_cpu) const noexcept {
+            return Valid(from_cpu, to_cpu) ? round_trips_[Index(from_cpu, to_cpu)] : 0;
+        }
+
+        /// Check if pair was measured (both CPUs in table and ping-pong succeeded)
+        [[nodiscard]] bool Valid(int from_cpu, int to_cpu) const noexcept {
+            return from_cpu >= 0 && to_cpu >= 0 &&
+                   positions_.size() > static_cast<std::size_t>(std::max(from_cpu, to_cpu)) &&
+                   positions_[static_cast<std::size_t>(from_cpu)] >= 0 &&
+                   positions_[static_cast<std::size_t>(to_cpu)] >= 0 &&
+                   valid_[Index(from_cpu, to_cpu)];
+        }
+
+        /// Translate timestamp taken on from_cpu into timebase of to_cpu (unchanged if pair is not Valid())
+        [[nodiscard]] TimePoint Correct(TimePoint tsc, int from_cpu, int to_cpu) const noexcept {
+            return tsc + static_cast<TimePoint>(Offset(from_cpu, to_cpu));
+        }
+
+        /// Largest absolute offset over all measured pairs in TSC ticks
+        [[nodiscard]] std::int64_t MaxAbsOffset() const noexcept {
+            std::int64_t max_offset = 0;
+            for (std::size_t i = 0; i < offsets_.size(); ++i) {
+                if (valid_[i]) {
+                    max_offset = std::max(max_offset, std::abs(offsets_[i]));
+                }
+            }
+            return max_offset;
+        }
+
+        /**
+         * @brief Check if all measured TSCs agree
+         * @param tolerance Allowed offset in TSC ticks on top of measurement uncertainty
+         * @return true if |offset| <= round trip / 2 + tolerance for every pair
+         */
+        [[nodiscard]] bool IsSynchronized(TimePoint tolerance) const noexcept {
+            for (std::size_t i = 0; i < offsets_.size(); ++i) {
+                if (valid_[i] && static_cast<TimePoint>(std::abs(offsets_[i])) > round_trips_[i] / 2 + tolerance) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+    private:
+        [[nodiscard]] std::size_t Index(int from_cpu, int to_cpu) const noexcept {
+            return static_cast<std::size_t>(positions_[static_cast<std::size_t>(from_cpu)]) * cpus_.size() +
+                   static_cast<std::size_t>(positions_[static_cast<std::size_t>(to_cpu)]);
+        }
+
+        std::vector<int> cpus_{};                   ///< Measured CPU cores
+        std::vector<int> positions_{};              ///< CPU id -> position in cpus_ (-1 if absent)
+        std::vector<std::int64_t> offsets_{};       ///< Row-major NxN offsets
+        std::vector<TimePoint> round_trips_{};      ///< Row-major NxN minimal round trips
+        std::vector<bool> valid_{};                 ///< Row-major NxN measurement validity
+    };
+
+
+    // Implementation
+    inline TscSkewTable TscSkewTable::Measure(const std::vector<int>& cpus, std::size_t rounds) {
+        TscSkewTable table{};
+        for (int cpu : cpus) {
+            if (cpu < 0) {
+                std::cerr << "[Warning] CPU core number must be >= 0, got: " << cpu << " - skipped" << std::endl;
+            } else if (std::find(table.cpus_.begin(), table.cpus_.end(), cpu) != table.cpus_.end()) {
+                std::cerr << "[Warning] CPU " << cpu << " is listed twice - duplicate skipped" << std::endl;
+            } else {
+                table.cpus_.push_back(cpu);
+            }
+        }
+        const std::size_t n = table.cpus_.size();
+        const int max_cpu = n == 0 ? -1 : *std::max_element(table.cpus_.begin(), table.cpus_.end());
+        table.positions_.assign(static_cast<std::size_t>(max_cpu + 1), -1);
+        for (std::size_t i = 0; i < n; ++i) {
+            table.positions_[static_cast<std::size_t>(table.cpus_[i])] = static_cast<int>(i);
+        }
+        table.offsets_.assign(n * n, 0);
+        table.round_trips_.assign(n * n, 0);
+        table.valid_.assign(n * n, false);
+
+        for (std::size_t i = 0; i < n; ++i) {
+            table.valid_[i * n + i] = true;
+            for (std::size_t j = i + 1; j < n; ++j) {
+                details::PingPongResult pair = details::MeasurePingPong(table.cpus_[i], table.cpus_[j], rounds);
+                if (!pair.valid_) {
+                    std::cerr << "[Warning] TSC offset between CPU " << table.cpus_[i] << " and CPU " << table.cpus_[j]
+                              << " was not measured" << std::endl;
+                    continue;
+                }
+                table.offsets_[i * n + j] = pair.offset_;
+                table.offsets_[j * n + i] = -pair.offset_;
+                table.round_trips_[i * n + j] = table.round_trips_[j * n + i] = pair.raw_min_round_trip_;
+                table.valid_[i * n + j] = table.valid_[j * n + i] = true;
+            }
+        }
+        return table;
+    }
+
+} // namespace benchmarking
@@ -0,0 +1,290 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "utils/types.h"
+
+namespace benchmarking {
+
+    /// Latency distribution summary of recorded samples (all values in TSC ticks)
+    class Distribution {
+    public:
+        /// Number of samples the summary is built from
+        std::size_t samples_number_{0};
+
+        /// Minimal sample
+        TimePoint min_{0};
+
+        /// Maximal sample
+        TimePoint max_{0};
+
+        /// Median (50th percentile)
+        TimePoint median_{0};
+
+        /// 90th percentile
+        TimePoint p90_{0};
+
+        /// 99th percentile
+        TimePoint p99_{0};
+
+        /// 99.9th percentile
+        TimePoint p999_{0};
+
+        /// Median absolute deviation from median
+        TimePoint mad_{0};
+
+        /// Arithmetic mean
+        double mean_{0.0};
+
+        /// Sample standard deviation
+        double stddev_{0.0};
+    };
+
+    namespace details {
+        /// Nearest-rank index of quantile in sorted sequence of given size
+        /// @param size Number of elements (must be > 0)
+        /// @param quantile Quantile in [0, 1]
+        /// @return 0-based index of element
+        inline std::size_t QuantileIndex(std::size_t size, double quantile) noexcept {
+            // Small epsilon keeps exact products (e.g. 0.9 * 10) from rounding up to next rank
+            auto rank = static_cast<std::size_t>(std::ceil(quantile * static_cast<double>(size) - 1e-9));
+            return std::clamp<std::size_t>(rank, 1, size) - 1;
+        }
+    } // namespace details
+
+    /**
+     * @brief Compute distribution summary of samples
+     *
+     * Percentiles are found with successive std::nth_element selections over shrinking
+     * ranges instead of a full sort. Samples are reordered (and overwritten by absolute
+     * deviations when computing MAD), so pass a scratch copy if order matters.
+     *
+     * @param samples Samples to summarize
+     * @return Distribution summary (empty if there are no samples)
+     */
+    inline Distribution ComputeDistribution(std::span<TimePoint> samples) {
+        Distribution distribution{};
+        const std::size_t n = samples.size();
+        if (n == 0) {
+            return distribution;
+        }
+        distribution.samples_number_ = n;
+
+        double sum = 0.0;
+        for (TimePoint sample : samples) {
+            sum += static_cast<double>(sample);
+        }
+        distribution.mean_ = sum / static_cast<double>(n);
+
+        double squares = 0.0;
+        for (TimePoint sample : samples) {
+            double delta = static_cast<double>(sample) - distribution.mean_;
+            squares += delta * delta;
+        }
+        distribution.stddev_ = n > 1 ? std::sqrt(squares / static_cast<double>(n - 1)) : 0.0;
+
+        // Quantile indices are monotonic: each selection only partitions tail left by previous one
+        auto first = samples.begin();
+        auto select = [&](double quantile) {
+            auto nth = samples.begin() + static_cast<std::ptrdiff_t>(details::QuantileIndex(n, quantile));
+            std::nth_element(first, nth, samples.end());
+            first = nth;
+            return *nth;
+        };
+
+        distribution.median_ = select(0.5);
+        auto median = first;
+        distribution.p90_ = select(0.9);
+        distribution.p99_ = select(0.99);
+        distribution.p999_ = select(0.999);
+        distribution.min_ = *std::min_element(samples.begin(), median + 1);
+        distribution.max_ = *std::max_element(first, samples.end());
+
+        // Reuse sample storage for absolute deviations
+        for (TimePoint& sample : samples) {
+            sample = sample > distribution.median_ ? sample - distribution.median_ : distribution.median_ - sample;
+        }
+        std::nth_element(samples.begin(), median, samples.end());
+        distribution.mad_ = *median;
+
+        return distribution;
+    }
+
+    /// Distribution-free confidence interval of quantile (all values in TSC ticks)
+    class QuantileInterval {
+    public:
+        /// Quantile in [0, 1]
+        double quantile_{0.5};
+
+        /// Lower bound of interval
+        TimePoint lower_{0};
+
+        /// Point estimate (nearest-rank quantile)
+        TimePoint estimate_{0};
+
+        /// Upper bound of interval
+        TimePoint upper_{0};
+
+        /// Interval width relative to estimate (infinity if estimate is 0)
+        [[nodiscard]] double RelativeWidth() const noexcept {
+            return estimate_ > 0 ? static_cast<double>(upper_ - lower_) / static_cast<double>(estimate_)
+                                 : std::numeric_limits<double>::infinity();
+        }
+    };
+
+    /**
+     * @brief Compute confidence interval of quantile from order statistics
+     *
+     * Rank of quantile q among n samples is Binomial(n, q), so bounds are order statistics at
+     * ranks n*q -/+ z*sqrt(n*q*(1-q)). No assumption is made about shape of distribution.
+     * Samples are reordered.
+     *
+     * @param samples Samples to summarize
+     * @param quantile Quantile in [0, 1]
+     * @param z Standard normal critical value (1.96 - 95% confidence)
+     * @return Interval (empty if there are no samples)
+     */
+    inline QuantileInterval ComputeQuantileInterval(std::span<TimePoint> samples, double quantile, double z = 1.96) {
+        QuantileInterval interval{};
+        interval.quantile_ = quantile;
+        const std::size_t n = samples.size();
+        if (n == 0) {
+            return interval;
+        }
+
+        const double center = quantile * static_cast<double>(n);
+        const double half_width = z * std::sqrt(static_cast<double>(n) * quantile * (1.0 - quantile));
+        const std::size_t estimate = details::QuantileIndex(n, quantile);
+        auto rank_index = [n](double rank) {
+            return static_cast<std::size_t>(std::clamp(rank, 1.0, static_cast<double>(n))) - 1;
+        };
+        const std::size_t lower = rank_index(std::floor(center - half_width));
+        const std::size_t upper = rank_index(std::ceil(center + half_width));
+
+        // Same shrinking-range selections as ComputeDistribution()
+        auto first = samples.begin();
+        auto select = [&](std::size_t index) {
+            auto nth = samples.begin() + static_cast<std::ptrdiff_t>(index);
+            std::nth_element(first, nth, samples.end());
+            first = nth;
+            return *nth;
+        };
+        interval.lower_ = select(std::min(lower, estimate));
+        interval.estimate_ = select(estimate);
+        interval.upper_ = select(std::max(upper, estimate));
+        return interval;
+    }
+
+    /**
+     * @brief Stopping rule of adaptive runs
+     *
+     * Sampling is converged once confidence intervals of both median and p99 are narrower
+     * than target_relative_ci_ of their estimates.
+     */
+    class ConvergenceRule {
+    public:
+        /// Target width of confidence interval relative to estimate (0.01 - 1%)
+        double target_relative_ci_{0.01};
+
+        /// Standard normal critical value of intervals (1.96 - 95% confidence)
+        double z_{1.96};
+
+        /// Minimal number of samples before convergence is checked
+        std::size_t min_samples_{100};
+
+        /**
+         * @brief Check if samples are converged
+         * @param samples Samples to check (reordered)
+         * @param median Output interval of median
+         * @param p99 Output interval of 99th percentile
+         * @return true if both intervals are tight enough
+         */
+        bool IsConverged(std::span<TimePoint> samples, QuantileInterval& median, QuantileInterval& p99) const {
+            median = ComputeQuantileInterval(samples, 0.5, z_);
+            p99 = ComputeQuantileInterval(samples, 0.99, z_);
+            return samples.size() >= min_samples_ &&
+                   median.RelativeWidth() <= target_relative_ci_ &&
+                   p99.RelativeWidth() <= target_relative_ci_;
+        }
+    };
+
+    /// Result of two-sided Mann-Whitney U test
+    class MannWhitneyResult {
+    public:
+        /// U statistic of first sample
+        double u_{0.0};
+
+        /// Standardized statistic (normal approximation with tie and continuity correction)
+        double z_{0.0};
+
+        /// Two-sided p-value
+        double p_value_{1.0};
+
+        /// Probability that value from first sample exceeds value from second (ties count half)
+        double effect_size_{0.5};
+    };
+
+    /**
+     * @brief Mann-Whitney U test of two independent samples
+     *
+     * Rank-sum test that makes no normality assumption, so it suits skewed latency samples.
+     * Uses normal approximation, which is accurate for samples of more than ~20 values.
+     *
+     * @param first First sample (e.g. current run)
+     * @param second Second sample (e.g. baseline)
+     * @return Test result (p_value_ 1 if either sample is empty)
+     */
+    inline MannWhitneyResult MannWhitneyU(std::span<const TimePoint> first, std::span<const TimePoint> second) {
+        MannWhitneyResult result{};
+        const std::size_t n1 = first.size(), n2 = second.size(), n = n1 + n2;
+        if (n1 == 0 || n2 == 0) {
+            return result;
+        }
+
+        // Pairs of (value, belongs to first sample) sorted by value
+        std::vector<std::pair<TimePoint, bool>> values;
+        values.reserve(n);
+        for (TimePoint value : first) {
+            values.emplace_back(value, true);
+        }
+        for (TimePoint value : second) {
+            values.emplace_back(value, false);
+        }
+        std::sort(values.begin(), values.end());
+
+        double first_rank_sum = 0.0, tie_term = 0.0;
+        for (std::size_t i = 0; i < n;) {
+            std::size_t j = i;
+            std::size_t first_in_tie = 0;
+            while (j < n && values[j].first == values[i].first) {
+                first_in_tie += values[j].second ? 1 : 0;
+                ++j;
+            }
+            const double ties = static_cast<double>(j - i);
+            const double average_rank = (static_cast<double>(i + 1) + static_cast<double>(j)) / 2.0;
+            first_rank_sum += average_rank * static_cast<double>(first_in_tie);
+            tie_term += ties * ties * ties - ties;
+            i = j;
+        }
+
+        const double size1 = static_cast<double>(n1), size2 = static_cast<double>(n2), size = static_cast<double>(n);
+        result.u_ = first_rank_sum - size1 * (size1 + 1.0) / 2.0;
+        result.effect_size_ = result.u_ / (size1 * size2);
+
+        const double mean = size1 * size2 / 2.0;
+        const double variance = size1 * size2 / 12.0 * ((size + 1.0) - tie_term / (size * (size - 1.0)));
+        if (variance <= 0.0) {
+            return result;
+        }
+        const double delta = std::abs(result.u_ - mean);
+        result.z_ = std::copysign(std::max(0.0, delta - 0.5) / std::sqrt(variance), result.u_ - mean);
+        result.p_value_ = std::erfc(std::abs(result.z_) / std::sqrt(2.0));
+        return result;
+    }
+
+} // namespace benchmarking
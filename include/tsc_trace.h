@@ -0,0 +1,245 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tsc_calibration.h"
+#include "tsc_cpu.h"
+#include "utils/affinity.h"
+#include "utils/compiler.h"
+#include "utils/mapped_file.h"
+#include "utils/spsc_ring.h"
+#include "utils/types.h"
+
+namespace benchmarking {
+
+    /// Timestamped pipeline event (16 bytes, four per cache line)
+    class TraceEvent {
+    public:
+        /// TSC value at event
+        TimePoint tsc_{0};
+
+        /// Application-defined event (stage) id
+        std::uint32_t event_id_{0};
+
+        /// Core number from RDTSCP (IA32_TSC_AUX)
+        std::uint16_t core_{0};
+
+        /// Chip (socket) number from RDTSCP (IA32_TSC_AUX)
+        std::uint16_t chip_{0};
+    };
+    static_assert(sizeof(TraceEvent) == 16, "TraceEvent must stay packed into 16 bytes");
+
+    /// Header of trace file written by TraceDrainer
+    class TraceHeader {
+    public:
+        static constexpr char kMagic[8] = {'T', 'S', 'C', 'T', 'R', 'A', 'C', 'E'};
+        static constexpr std::uint32_t kVersion = 1;
+
+        char magic_[8]{};
+        std::uint32_t version_{kVersion};
+
+        /// Size of TraceEvent in bytes
+        std::uint32_t event_bytes_{sizeof(TraceEvent)};
+
+        /// Calibrated TSC frequency in Hz (0 - uncalibrated)
+        double tsc_hz_{0.0};
+
+        /// Events dropped because ring was full (updated on Stop())
+        std::uint64_t dropped_{0};
+    };
+
+    /**
+     * @brief Producer side of trace ring (owned by traced thread)
+     *
+     * Record() costs one RDTSCP and one ring slot write guarded by release store; when consumer
+     * falls behind, events are dropped and counted instead of blocking traced thread.
+     *
+     * @tparam Capacity Ring slots (power of two)
+     */
+    template<std::size_t Capacity = (1u << 16)>
+    class TraceRing {
+    public:
+        /// Record event with current TSC and core (traced thread only)
+        FORCE_INLINE void Record(std::uint32_t event_id) noexcept {
+            TraceEvent event{};
+            CpuId chip{0}, core{0};
+            event.tsc_ = details::Rdtscp(chip, core);
+            event.event_id_ = event_id;
+            event.core_ = static_cast<std::uint16_t>(core);
+            event.chip_ = static_cast<std::uint16_t>(chip);
+            if (UNLIKELY(!ring_.TryPush(event))) {
+                dropped_.store(dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+        }
+
+        /// Move queued events to out (consumer thread only)
+        std::size_t Drain(TraceEvent* out, std::size_t count) noexcept { return ring_.PopBulk(out, count); }
+
+        /// Events dropped so far
+        [[nodiscard]] std::uint64_t Dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+    private:
+        details::SpscRing<TraceEvent, Capacity> ring_{};
+        alignas(kCacheLineSize) std::atomic<std::uint64_t> dropped_{0};
+    };
+
+    /**
+     * @brief Consumer thread draining TraceRing into memory-mapped file
+     *
+     * Example usage:
+     * @code
+     * TraceRing<> ring{};
+     * TraceDrainer<> drainer{};
+     * drainer.Start(ring, "pipeline.trace", calibration);
+     * ring.Record(kStageParsed);  // traced thread
+     * drainer.Stop();
+     * @endcode
+     */
+    template<std::size_t Capacity = (1u << 16)>
+    class TraceDrainer {
+    public:
+        TraceDrainer() = default;
+        TraceDrainer(const TraceDrainer&) = delete;
+        TraceDrainer& operator=(const TraceDrainer&) = delete;
+
+        ~TraceDrainer() { Stop(); }
+
+        /**
+         * @brief Create trace file and start drainer thread
+         * @param ring Ring to drain (must outlive drainer)
+         * @param path Trace file path
+         * @param calibration TSC calibration stored in header
+         * @param cpu CPU core drainer is pinned to (-1 - not pinned)
+         * @return false if file could not be created
+         */
+        bool Start(TraceRing<Capacity>& ring, const std::string& path, const TSCCalibration& calibration, int cpu = -1);
+
+        /// Drain remaining events, write drop count and close file
+        void Stop();
+
+        /// Events written so far
+        [[nodiscard]] std::uint64_t Written() const noexcept { return written_.load(std::memory_order_relaxed); }
+
+    private:
+        static constexpr std::size_t kBatchSize = 1024;
+
+        void Run();
+
+        TraceRing<Capacity>* ring_{nullptr};
+        details::MappedFile file_{};
+        std::thread thread_{};
+        std::atomic<bool> stop_{false};
+        std::atomic<std::uint64_t> written_{0};
+    };
+
+    /**
+     * @brief Zero-copy view of trace file
+     *
+     * Events() points into mapping, so reading a multi-gigabyte trace does not copy it.
+     */
+    class TraceReader {
+    public:
+        /// Map trace file
+        /// @return false if file is missing or not a trace
+        bool Open(const std::string& path) {
+            if (!file_.OpenReadOnly(path)) {
+                return false;
+            }
+            if (file_.Size() < sizeof(TraceHeader)) {
+                std::cerr << "[Warning] " << path << " is too short to be a trace" << std::endl;
+                return false;
+            }
+            std::memcpy(&header_, file_.Data(), sizeof(TraceHeader));
+            if (std::memcmp(header_.magic_, TraceHeader::kMagic, sizeof(header_.magic_)) != 0 ||
+                header_.version_ != TraceHeader::kVersion || header_.event_bytes_ != sizeof(TraceEvent)) {
+                std::cerr << "[Warning] " << path << " is not a trace of this version" << std::endl;
+                return false;
+            }
+            return true;
+        }
+
+        [[nodiscard]] const TraceHeader& Header() const noexcept { return header_; }
+
+        /// Recorded events in order of recording
+        [[nodiscard]] std::span<const TraceEvent> Events() const noexcept {
+            const std::size_t count = (file_.Size() - sizeof(TraceHeader)) / sizeof(TraceEvent);
+            return {reinterpret_cast<const TraceEvent*>(file_.Data() + sizeof(TraceHeader)), count};
+        }
+
+    private:
+        details::MappedFile file_{};
+        TraceHeader header_{};
+    };
+
+
+    // Implementation
+    template<std::size_t Capacity>
+    bool TraceDrainer<Capacity>::Start(TraceRing<Capacity>& ring, const std::string& path,
+                                       const TSCCalibration& calibration, int cpu) {
+        Stop();
+        if (!file_.Create(path)) {
+            return false;
+        }
+        TraceHeader header{};
+        std::memcpy(header.magic_, TraceHeader::kMagic, sizeof(header.magic_));
+        header.tsc_hz_ = calibration.Frequency();
+        file_.Append(&header, sizeof(header));
+
+        ring_ = &ring;
+        written_ = 0;
+        stop_ = false;
+        thread_ = std::thread{[this, cpu]() {
+            if (cpu >= 0 && !details::PinThread(cpu, false)) {
+                std::cerr << "[Warning] Failed to pin trace drainer to CPU " << cpu << std::endl;
+            }
+            Run();
+        }};
+        return true;
+    }
+
+    template<std::size_t Capacity>
+    void TraceDrainer<Capacity>::Stop() {
+        if (!thread_.joinable()) {
+            return;
+        }
+        stop_.store(true, std::memory_order_release);
+        thread_.join();
+        TraceHeader header{};
+        std::memcpy(&header, file_.Data(), sizeof(header));
+        header.dropped_ = ring_->Dropped();
+        std::memcpy(file_.Data(), &header, sizeof(header));
+        if (header.dropped_ > 0) {
+            std::cerr << "[Warning] Trace ring dropped " << header.dropped_ << " events - drainer fell behind" << std::endl;
+        }
+        file_.Close();
+    }
+
+    template<std::size_t Capacity>
+    void TraceDrainer<Capacity>::Run() {
+        std::vector<TraceEvent> batch(kBatchSize);
+        for (;;) {
+            const bool stopping = stop_.load(std::memory_order_acquire);
+            const std::size_t count = ring_->Drain(batch.data(), batch.size());
+            if (count > 0) {
+                if (!file_.Append(batch.data(), count * sizeof(TraceEvent))) {
+                    return;
+                }
+                written_.store(written_.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+            } else if (stopping) {
+                // Stop was requested before ring was seen empty - nothing is left behind
+                return;
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds{100});
+            }
+        }
+    }
+
+} // namespace benchmarking
@@ -7,13 +7,15 @@
 #include <sys/syscall.h>
 #include <cstring>
 #include <cerrno>
+#include <vector>
 
 namespace benchmarking::details {
 
     /// Pin current thread to specific CPU core (Linux x86 implementation)
     /// @param cpu CPU core number (0-based)
+    /// @param verbose Print info message on success
     /// @return true if successful, false otherwise
-    bool PinThread(int cpu) noexcept {
+    inline bool PinThread(int cpu, bool verbose = true) noexcept {
         if (cpu < 0) {
             std::cerr << "[Warning] CPU core number must be >= 0, got: " << cpu << std::endl;
             return false;
@@ -29,15 +31,27 @@ namespace benchmarking::details {
             return false;
         }
         
-        std::cout << "[Info] Thread pinned to CPU " << cpu << std::endl;
+        if (verbose) {
+            std::cout << "[Info] Thread pinned to CPU " << cpu << std::endl;
+        }
         return true;
     }
 
     /// Get number of available CPU cores (Linux implementation)
     /// @return number of CPU cores
-    int GetCpuCoreCount() noexcept {
+    inline int GetCpuCoreCount() noexcept {
         int cores = static_cast<int>(sysconf(_SC_NPROCESSORS_ONLN));
         return cores > 0 ? cores : 1;
     }
 
+    /// Get ids of all available CPU cores
+    /// @return CPU cores 0..GetCpuCoreCount()-1
+    inline std::vector<int> GetCpuList() {
+        std::vector<int> cpus(static_cast<std::size_t>(GetCpuCoreCount()));
+        for (std::size_t i = 0; i < cpus.size(); ++i) {
+            cpus[i] = static_cast<int>(i);
+        }
+        return cpus;
+    }
+
 } // namespace benchmarking::details
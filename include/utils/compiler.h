@@ -5,6 +5,11 @@
     #define FORCE_INLINE inline __attribute__((always_inline))
 #endif
 
+// Force inline attribute for lambdas, placed after parameter list (GCC/Clang)
+#ifndef FORCE_INLINE_LAMBDA
+    #define FORCE_INLINE_LAMBDA __attribute__((always_inline))
+#endif
+
 // Branch prediction hints (GCC/Clang)
 #ifndef LIKELY
     #define LIKELY(x) __builtin_expect(!!(x), 1)
@@ -15,3 +20,58 @@
 #ifndef COMPILER_BARRIER
     #define COMPILER_BARRIER() __asm__ __volatile__("" ::: "memory")
 #endif
+
+// Spin-wait hint (x86 PAUSE)
+#ifndef CPU_RELAX
+    #define CPU_RELAX() __builtin_ia32_pause()
+#endif
+
+#include <type_traits>
+#include <utility>
+
+namespace benchmarking {
+
+    /**
+     * @brief Force value to be materialized without extra stores
+     *
+     * Value is passed to empty inline asm in register (or memory for large or non-trivial types),
+     * so computation producing it cannot be removed, unlike volatile locals no store is emitted.
+     */
+    template<typename T>
+    FORCE_INLINE void DoNotOptimize(const T& value) noexcept {
+        if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(void*)) {
+            __asm__ __volatile__("" :: "r"(value) : "memory");
+        } else {
+            __asm__ __volatile__("" :: "m"(value) : "memory");
+        }
+    }
+
+    /// Force value to be materialized and treat it as modified (later reads cannot be constant-folded)
+    template<typename T>
+    FORCE_INLINE void DoNotOptimize(T& value) noexcept {
+        if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(void*)) {
+            __asm__ __volatile__("" : "+r"(value) :: "memory");
+        } else {
+            __asm__ __volatile__("" : "+m"(value) :: "memory");
+        }
+    }
+
+    /// Force all pending writes to memory to be emitted (reads after it are not cached in registers)
+    FORCE_INLINE void ClobberMemory() noexcept {
+        COMPILER_BARRIER();
+    }
+
+    namespace details {
+        /// Invoke code and sink its return value (if any) with DoNotOptimize()
+        template<typename Code, typename... Args>
+        FORCE_INLINE void InvokeAndSink(Code& code, Args&&... args) {
+            if constexpr (std::is_void_v<std::invoke_result_t<Code&, Args...>>) {
+                code(std::forward<Args>(args)...);
+            } else {
+                auto&& value = code(std::forward<Args>(args)...);
+                DoNotOptimize(value);
+            }
+        }
+    } // namespace details
+
+} // namespace benchmarking
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <utility>
+
+// Linux system includes
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace benchmarking::details {
+
+    /**
+     * @brief Memory-mapped file for append-only writing or zero-copy reading
+     *
+     * Writer mode grows file and mapping geometrically; Close() truncates file to appended size.
+     */
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        MappedFile(MappedFile&& other) noexcept { *this = std::move(other); }
+
+        MappedFile& operator=(MappedFile&& other) noexcept {
+            if (this != &other) {
+                Close();
+                std::swap(fd_, other.fd_);
+                std::swap(data_, other.data_);
+                std::swap(size_, other.size_);
+                std::swap(capacity_, other.capacity_);
+                std::swap(writable_, other.writable_);
+            }
+            return *this;
+        }
+
+        ~MappedFile() { Close(); }
+
+        /**
+         * @brief Create (or truncate) file for appending
+         * @param path File path
+         * @param capacity Initial mapped size in bytes (file is prefaulted up to it)
+         * @return true if successful, false otherwise
+         */
+        bool Create(const std::string& path, std::size_t capacity = kDefaultCapacity) {
+            Close();
+            fd_ = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+            if (fd_ < 0) {
+                std::cerr << "[Warning] Failed to create " << path << ": " << std::strerror(errno) << std::endl;
+                return false;
+            }
+            writable_ = true;
+            size_ = 0;
+            if (!Reserve(std::max(capacity, kPageSize))) {
+                Close();
+                return false;
+            }
+            return true;
+        }
+
+        /**
+         * @brief Map existing file read-only
+         * @param path File path
+         * @return true if successful, false otherwise
+         */
+        bool OpenReadOnly(const std::string& path) {
+            Close();
+            fd_ = open(path.c_str(), O_RDONLY);
+            if (fd_ < 0) {
+                std::cerr << "[Warning] Failed to open " << path << ": " << std::strerror(errno) << std::endl;
+                return false;
+            }
+            struct stat status{};
+            if (fstat(fd_, &status) != 0) {
+                std::cerr << "[Warning] Failed to stat " << path << ": " << std::strerror(errno) << std::endl;
+                Close();
+                return false;
+            }
+            size_ = capacity_ = static_cast<std::size_t>(status.st_size);
+            if (size_ > 0) {
+                void* memory = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+                if (memory == MAP_FAILED) {
+                    std::cerr << "[Warning] Failed to map " << path << ": " << std::strerror(errno) << std::endl;
+                    Close();
+                    return false;
+                }
+                data_ = static_cast<std::byte*>(memory);
+                madvise(data_, size_, MADV_SEQUENTIAL);
+            }
+            return true;
+        }
+
+        /// Append bytes (grows mapping if needed)
+        bool Append(const void* data, std::size_t size) {
+            std::byte* destination = Extend(size);
+            if (destination == nullptr) {
+                return false;
+            }
+            std::memcpy(destination, data, size);
+            return true;
+        }
+
+        /// Reserve size bytes at end of file and return pointer to them (valid until next Extend(), nullptr on failure)
+        [[nodiscard]] std::byte* Extend(std::size_t size) {
+            if (!writable_ || (size_ + size > capacity_ && !Reserve(std::max(capacity_ * 2, size_ + size)))) {
+                return nullptr;
+            }
+            std::byte* destination = data_ + size_;
+            size_ += size;
+            return destination;
+        }
+
+        /// Unmap and close file (writer mode truncates file to appended size)
+        void Close() noexcept {
+            if (data_ != nullptr) {
+                munmap(data_, capacity_);
+            }
+            if (fd_ >= 0) {
+                if (writable_ && ftruncate(fd_, static_cast<off_t>(size_)) != 0) {
+                    std::cerr << "[Warning] Failed to truncate mapped file: " << std::strerror(errno) << std::endl;
+                }
+                close(fd_);
+            }
+            fd_ = -1;
+            data_ = nullptr;
+            size_ = capacity_ = 0;
+            writable_ = false;
+        }
+
+        /// Mapped bytes (appended bytes in writer mode)
+        [[nodiscard]] const std::byte* Data() const noexcept { return data_; }
+        [[nodiscard]] std::byte* Data() noexcept { return data_; }
+
+        /// Appended (writer) or file (reader) size in bytes
+        [[nodiscard]] std::size_t Size() const noexcept { return size_; }
+
+        [[nodiscard]] bool IsOpen() const noexcept { return fd_ >= 0; }
+
+    private:
+        static constexpr std::size_t kPageSize = 4096;
+        static constexpr std::size_t kDefaultCapacity = 1u << 20;
+
+        bool Reserve(std::size_t capacity) {
+            capacity = (capacity + kPageSize - 1) & ~(kPageSize - 1);
+            if (ftruncate(fd_, static_cast<off_t>(capacity)) != 0) {
+                std::cerr << "[Warning] Failed to grow mapped file: " << std::strerror(errno) << std::endl;
+                return false;
+            }
+            void* memory = data_ == nullptr
+                           ? mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, 0)
+                           : mremap(data_, capacity_, capacity, MREMAP_MAYMOVE);
+            if (memory == MAP_FAILED) {
+                std::cerr << "[Warning] Failed to map file: " << std::strerror(errno) << std::endl;
+                return false;
+            }
+            data_ = static_cast<std::byte*>(memory);
+            capacity_ = capacity;
+            return true;
+        }
+
+        int fd_{-1};
+        std::byte* data_{nullptr};
+        std::size_t size_{0};
+        std::size_t capacity_{0};
+        bool writable_{false};
+    };
+
+} // namespace benchmarking::details
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstring>
+#include <cerrno>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+namespace benchmarking::details {
+
+    // Memory policy constants of mbind() (linux/mempolicy.h) - libnuma is not required
+    inline constexpr int kMpolBind = 2;
+    inline constexpr unsigned kMpolMfStrict = 1u << 0;
+    inline constexpr unsigned kMpolMfMove = 1u << 1;
+
+    /// Get ids of online NUMA nodes (/sys/devices/system/node/online)
+    /// @return Node ids (just node 0 if NUMA information is not available)
+    inline std::vector<int> GetNumaNodeList() {
+        std::vector<int> nodes;
+        std::ifstream online{"/sys/devices/system/node/online"};
+        std::string list;
+        if (online >> list) {
+            std::stringstream stream{list};
+            for (std::string range; std::getline(stream, range, ',');) {
+                std::size_t dash = range.find('-');
+                int first = std::stoi(range.substr(0, dash));
+                int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+                for (int node = first; node <= last; ++node) {
+                    nodes.push_back(node);
+                }
+            }
+        }
+        if (nodes.empty()) {
+            nodes.push_back(0);
+        }
+        return nodes;
+    }
+
+    /// Get NUMA node of CPU core
+    /// @param cpu CPU core number (0-based)
+    /// @return Node id (0 if NUMA information is not available)
+    inline int GetCpuNumaNode(int cpu) {
+        for (int node : GetNumaNodeList()) {
+            const std::string path = "/sys/devices/system/node/node" + std::to_string(node) + "/cpu" + std::to_string(cpu);
+            if (access(path.c_str(), F_OK) == 0) {
+                return node;
+            }
+        }
+        return 0;
+    }
+
+    /// Bind memory range to NUMA node (mbind() with MPOL_BIND)
+    /// @param address Page-aligned start of range
+    /// @param size Size of range in bytes
+    /// @param node Target node
+    /// @return true if successful, false otherwise
+    inline bool BindToNumaNode(void* address, std::size_t size, int node) noexcept {
+        if (node < 0 || node >= 63) {
+            std::cerr << "[Warning] NUMA node " << node << " is out of supported range" << std::endl;
+            return false;
+        }
+        unsigned long mask = 1ul << node;
+        const long result = syscall(SYS_mbind, address, size, kMpolBind, &mask, sizeof(mask) * 8,
+                                    kMpolMfStrict | kMpolMfMove);
+        if (result != 0) {
+            std::cerr << "[Warning] Failed to bind memory to NUMA node " << node
+                      << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+} // namespace benchmarking::details
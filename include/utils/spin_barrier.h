@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <sched.h>
+
+#include "compiler.h"
+#include "types.h"
+
+namespace benchmarking::details {
+
+    /// Spin on predicate, yielding to scheduler after a bounded number of spins
+    /// Yielding keeps oversubscribed cores (e.g. SCHED_FIFO threads sharing a CPU) from livelocking
+    template<typename Predicate>
+    FORCE_INLINE void SpinUntil(Predicate&& predicate) noexcept {
+        constexpr std::size_t kSpinsBeforeYield = 1u << 16;
+        for (std::size_t spins = 0; !predicate(); ++spins) {
+            if (LIKELY(spins < kSpinsBeforeYield)) {
+                CPU_RELAX();
+            } else {
+                sched_yield();
+            }
+        }
+    }
+
+    /// Sense-reversing spin barrier for pinned threads
+    class SpinBarrier {
+    public:
+        /// @param participants Number of threads calling ArriveAndWait() per phase
+        explicit SpinBarrier(std::size_t participants) noexcept
+            : participants_{participants}, remaining_{participants} {}
+
+        SpinBarrier(const SpinBarrier&) = delete;
+        SpinBarrier& operator=(const SpinBarrier&) = delete;
+
+        /// Block (spinning) until all participants arrive
+        void ArriveAndWait() noexcept {
+            const bool sense = sense_.load(std::memory_order_relaxed);
+            if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                remaining_.store(participants_, std::memory_order_relaxed);
+                sense_.store(!sense, std::memory_order_release);
+                return;
+            }
+            SpinUntil([this, sense]() { return sense_.load(std::memory_order_acquire) != sense; });
+        }
+
+    private:
+        const std::size_t participants_;
+        alignas(kCacheLineSize) std::atomic<std::size_t> remaining_;
+        alignas(kCacheLineSize) std::atomic<bool> sense_{false};
+    };
+
+} // namespace benchmarking::details
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+#include "compiler.h"
+#include "types.h"
+
+namespace benchmarking::details {
+
+    /**
+     * @brief Bounded single-producer/single-consumer ring buffer
+     *
+     * Indices live on separate cache lines and each side caches the other side's index, so
+     * producer touches consumer's line only when ring looks full. Synchronization is one
+     * acquire load (rarely) and one release store per operation - no read-modify-write.
+     *
+     * @tparam T Trivially copyable element
+     * @tparam Capacity Number of slots (power of two)
+     */
+    template<typename T, std::size_t Capacity>
+    class SpscRing {
+        static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be power of two");
+        static_assert(std::is_trivially_copyable_v<T>, "Ring elements must be trivially copyable");
+
+    public:
+        SpscRing() = default;
+        SpscRing(const SpscRing&) = delete;
+        SpscRing& operator=(const SpscRing&) = delete;
+
+        /// Append element (producer thread only)
+        /// @return false if ring is full
+        FORCE_INLINE bool TryPush(const T& value) noexcept {
+            const std::size_t head = head_.load(std::memory_order_relaxed);
+            if (UNLIKELY(head - cached_tail_ == Capacity)) {
+                cached_tail_ = tail_.load(std::memory_order_acquire);
+                if (head - cached_tail_ == Capacity) {
+                    return false;
+                }
+            }
+            slots_[head & kMask] = value;
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Remove up to count elements (consumer thread only)
+         * @param out Destination of at least count elements
+         * @param count Maximal number of elements
+         * @return Number of elements removed
+         */
+        std::size_t PopBulk(T* out, std::size_t count) noexcept {
+            const std::size_t tail = tail_.load(std::memory_order_relaxed);
+            if (cached_head_ == tail) {
+                cached_head_ = head_.load(std::memory_order_acquire);
+            }
+            const std::size_t available = std::min(cached_head_ - tail, count);
+            for (std::size_t i = 0; i < available; ++i) {
+                out[i] = slots_[(tail + i) & kMask];
+            }
+            tail_.store(tail + available, std::memory_order_release);
+            return available;
+        }
+
+        /// Remove one element (consumer thread only)
+        /// @return false if ring is empty
+        bool TryPop(T& value) noexcept { return PopBulk(&value, 1) == 1; }
+
+        /// Approximate number of queued elements (any thread)
+        [[nodiscard]] std::size_t Size() const noexcept {
+            return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+        }
+
+        static constexpr std::size_t kCapacity = Capacity;
+
+    private:
+        static constexpr std::size_t kMask = Capacity - 1;
+
+        alignas(kCacheLineSize) std::atomic<std::size_t> head_{0};    ///< Next slot written by producer
+        std::size_t cached_tail_{0};                                   ///< Producer's copy of tail_
+        alignas(kCacheLineSize) std::atomic<std::size_t> tail_{0};    ///< Next slot read by consumer
+        std::size_t cached_head_{0};                                   ///< Consumer's copy of head_
+        alignas(kCacheLineSize) std::array<T, Capacity> slots_{};
+    };
+
+} // namespace benchmarking::details
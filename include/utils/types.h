@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 namespace benchmarking {
@@ -13,9 +14,15 @@ namespace benchmarking {
     /// Type for CPU core/chip identification
     using CpuId = std::uint32_t;
 
+    /// Cache line size used for padding shared data
+    inline constexpr std::size_t kCacheLineSize = 64;
+
     namespace details {
         /// Internal register type for low-level operations
         using InternalRegister = std::uint32_t;
+
+        /// Unsigned 128-bit integer for fixed-point arithmetic (GCC/Clang extension)
+        __extension__ typedef unsigned __int128 UInt128;
     }
 
 } // namespace benchmarking